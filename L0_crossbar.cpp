@@ -0,0 +1,108 @@
+#include <systemc.h>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <chrono>
+#include "router.h"
+
+// Level 0: throughput-ul agregat al unui singur router, bucla originala (un pachet pe ciclu)
+// vs modul crossbar (SET_SWITCH), cu trafic all-to-all care satureaza toate cele 5 intrari.
+// Rulare: ./xbar_bench [cycles] [pattern]   pattern = rotate (permutari fara conflict) | random (iesire aleatoare)
+
+// Sursa saturata: scrie pachete cat de repede o lasa FIFO-ul de intrare al routerului.
+// Destinatia e id-ul portului de iesire (routerul e configurat cu Dst p -> Port p).
+SC_MODULE(Saturator) {
+    sc_fifo_out<packet> out_port;
+    int my_port;
+    bool random_dst;
+
+    void run() {
+        std::mt19937 rng(1234 + my_port);
+        std::uniform_int_distribution<int> pick(1, NUM_PORTS - 1);
+        for (int k = 0; ; k++) {
+            // rotate: la pasul k toate intrarile trimit la (port + 1 + k % 4) -> o permutare, fara conflicte
+            int offset = random_dst ? pick(rng) : 1 + k % (NUM_PORTS - 1);
+            out_port.write(packet(packet::REQ_WRITE, my_port, (my_port + offset) % NUM_PORTS, k, k));
+        }
+    }
+
+    SC_HAS_PROCESS(Saturator);
+    Saturator(sc_module_name name, int port, bool rnd) : sc_module(name), my_port(port), random_dst(rnd) {
+        SC_THREAD(run);
+    }
+};
+
+SC_MODULE(Sink) {
+    sc_fifo_in<packet> in_port;
+    unsigned long received;
+
+    void run() {
+        while (true) {
+            in_port.read();
+            received++;
+        }
+    }
+
+    SC_HAS_PROCESS(Sink);
+    Sink(sc_module_name name) : sc_module(name), received(0) {
+        SC_THREAD(run);
+    }
+};
+
+// Un router cu 5 surse si 5 destinatii
+struct Bench {
+    Router* router;
+    sc_fifo<cfg_trans>* cfg;
+    Sink* sinks[NUM_PORTS];
+
+    Bench(const char* name, int mode, bool random_dst) {
+        router = new Router(name);
+        cfg = new sc_fifo<cfg_trans>(16);
+        router->cfg_port(*cfg);
+
+        for (int p = 0; p < NUM_PORTS; p++) {
+            std::string base = std::string(name) + "_" + PortNames[p];
+            Saturator* src = new Saturator((base + "_src").c_str(), p, random_dst);
+            sinks[p] = new Sink((base + "_sink").c_str());
+
+            sc_fifo<packet>* f_in = new sc_fifo<packet>(4);
+            sc_fifo<packet>* f_out = new sc_fifo<packet>(4);
+            src->out_port(*f_in);
+            router->in_ports[p](*f_in);
+            router->out_ports[p](*f_out);
+            sinks[p]->in_port(*f_out);
+
+            cfg->write(cfg_trans(cfg_trans::SET_ROUTE, p, p));
+        }
+        cfg->write(cfg_trans(cfg_trans::SET_ARBITER, 0, ROUND_ROBIN));
+        cfg->write(cfg_trans(cfg_trans::SET_SWITCH, 0, mode));
+    }
+
+    unsigned long delivered() const {
+        unsigned long sum = 0;
+        for (int p = 0; p < NUM_PORTS; p++) sum += sinks[p]->received;
+        return sum;
+    }
+};
+
+int sc_main(int argc, char* argv[]) {
+    int cycles = (argc > 1) ? atoi(argv[1]) : 10000;
+    bool random_dst = (argc > 2) && strcmp(argv[2], "random") == 0;
+
+    Bench single("Single", SWITCH_SINGLE, random_dst);
+    Bench xbar("Crossbar", SWITCH_CROSSBAR, random_dst);
+
+    cout << "--- START L0 CROSSBAR BENCH (" << cycles << " cycles, " << (random_dst ? "random" : "rotate") << " all-to-all) ---" << endl;
+
+    auto wall_start = std::chrono::steady_clock::now();
+    sc_start(single.router->cycle_time * cycles);
+    auto wall_end = std::chrono::steady_clock::now();
+
+    double s = (double)single.delivered() / cycles;
+    double x = (double)xbar.delivered() / cycles;
+    cout << "Single-grant loop: " << s << " pkt/cycle (" << s / NUM_PORTS * 100 << "% of " << NUM_PORTS << " outputs)" << endl;
+    cout << "Crossbar:          " << x << " pkt/cycle (" << x / NUM_PORTS * 100 << "% of " << NUM_PORTS << " outputs)" << endl;
+    cout << "Speedup: " << x / s << "x | Wall time: "
+         << std::chrono::duration<double, std::milli>(wall_end - wall_start).count() << " ms" << endl;
+    return 0;
+}
@@ -7,12 +7,12 @@ using namespace std;
 int sc_main(int argc, char* argv[]) {
     Router r1("Router1");
 
-    sc_fifo<packet> fifo_in[4];
-    sc_fifo<packet> fifo_out[4];
+    sc_fifo<packet> fifo_in[NUM_PORTS];
+    sc_fifo<packet> fifo_out[NUM_PORTS];
     sc_fifo<cfg_trans> fifo_cfg;
 
     r1.cfg_port(fifo_cfg);
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < NUM_PORTS; i++) {
         r1.in_ports[i](fifo_in[i]);
         r1.out_ports[i](fifo_out[i]);
     }
@@ -1,10 +1,19 @@
 #include <systemc.h>
 #include <vector>
 #include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
 #include "utils.h"
 #include "router.h"
 #include "cpu_v1.h"
 #include "mem.h"
+#include "stats.h"
+#include "checkpoint.h"
+#include "topology.h"
 
 // funtie pt a genera nume diferite pentru fiecare modul
 std::string gen_name(const char* prefix, int id) {
@@ -20,16 +29,34 @@ SC_MODULE(Network) {
     std::vector<MEM*> mems;
 
     // Avem 7 segmente între 8 routere. Fiecare segment e dublu (dus-întors).
-    sc_fifo<packet>* link_fwd[7]; // Est -> Vest
-    sc_fifo<packet>* link_bwd[7]; // Vest -> Est
+    stat_fifo<packet>* link_fwd[7]; // Est -> Vest
+    stat_fifo<packet>* link_bwd[7]; // Vest -> Est
+    // Reteaua virtuala de raspunsuri: pe aceleasi segmente, FIFO-uri separate pentru RSP_ACK / RSP_DATA (NULL daca
+    // msg_classes e oprit si cererile impart legaturile cu raspunsurile, ca inainte)
+    stat_fifo<packet>* rsp_fwd[7];
+    stat_fifo<packet>* rsp_bwd[7];
+    bool msg_classes;
 
-    // Cabluri pentru periferice (CPU/MEM) si porturi închise, le salvez in vector sa nu se piarda referintele 
-    std::vector<sc_fifo<packet>*> periph_fifos;
+    // FIFO-ul pe care scrie fiecare MEM (paralel cu mems): write_stalls > 0 = memoria a stat blocata pe raspuns
+    std::vector<stat_fifo<packet>*> mem_rsp_fifos;
+
+    // Toate FIFO-urile pe care circula pachete (fara cele dummy), pentru raportul de ocupanta
+    std::vector<stat_fifo<packet>*> monitored_fifos;
+
+    // Cabluri pentru porturile închise, le salvez in vector sa nu se piarda referintele
+    // (cele catre periferice (CPU/MEM) sunt in monitored_fifos)
+    std::vector<sc_fifo<packet>*> closed_fifos;
 
     // Porturile de configurare pentru fiecare router
     sc_fifo_in<cfg_trans> cfg_ports[8];
 
-    SC_CTOR(Network) {
+    // Graful retelei, completat pe masura ce legam routerele si perifericele; din el iese rutarea
+    Topology topo;
+
+    // extra_cpus: CPU-uri in plus pe porturile N/S libere ale routerelor 2..7 (cel mult 12), pe rand catre MEM 83 si MEM 200,
+    // deci fiecare segment duce si cereri si raspunsuri in ambele sensuri
+    SC_HAS_PROCESS(Network);
+    Network(sc_module_name name, int extra_cpus = 0, bool classes = true) : sc_module(name), msg_classes(classes), topo(8) {
         // Instantierea routerelor
         for (int i = 0; i < 8; i++) {
             routers[i] = new Router(gen_name("Router", i+1).c_str());
@@ -38,8 +65,10 @@ SC_MODULE(Network) {
 
         // conectare lantul Est-Vest între routere
         for (int i = 0; i < 7; i++) {
-            link_fwd[i] = new sc_fifo<packet>(16);
-            link_bwd[i] = new sc_fifo<packet>(16);
+            link_fwd[i] = new stat_fifo<packet>(gen_name("link_fwd", i).c_str(), 16);
+            link_bwd[i] = new stat_fifo<packet>(gen_name("link_bwd", i).c_str(), 16);
+            monitored_fifos.push_back(link_fwd[i]);
+            monitored_fifos.push_back(link_bwd[i]);
 
             // R[i] ieșire Est -> R[i+1] intrare Vest
             routers[i]->out_ports[E](*link_fwd[i]);
@@ -48,6 +77,20 @@ SC_MODULE(Network) {
             // R[i+1] ieșire Vest -> R[i] intrare Est
             routers[i+1]->out_ports[V](*link_bwd[i]);
             routers[i]->in_ports[E](*link_bwd[i]);
+
+            topo.add_link(i, E, i+1);
+            topo.add_link(i+1, V, i);
+
+            rsp_fwd[i] = rsp_bwd[i] = NULL;
+            if (!msg_classes) continue;
+            rsp_fwd[i] = new stat_fifo<packet>(gen_name("rsp_fwd", i).c_str(), 16);
+            rsp_bwd[i] = new stat_fifo<packet>(gen_name("rsp_bwd", i).c_str(), 16);
+            monitored_fifos.push_back(rsp_fwd[i]);
+            monitored_fifos.push_back(rsp_bwd[i]);
+            routers[i]->rsp_out[E](*rsp_fwd[i]);
+            routers[i+1]->rsp_in[V](*rsp_fwd[i]);
+            routers[i+1]->rsp_out[V](*rsp_bwd[i]);
+            routers[i]->rsp_in[E](*rsp_bwd[i]);
         }
 
         // Conectare CPU la Router
@@ -56,16 +99,19 @@ SC_MODULE(Network) {
             cpus.push_back(c);
 
             // Firul 1: CPU -> Router (Request)
-            sc_fifo<packet>* f_req = new sc_fifo<packet>(16);
+            stat_fifo<packet>* f_req = new stat_fifo<packet>(gen_name("CPU_req", id).c_str(), 16);
             c->out_port(*f_req);
             routers[r_idx]->in_ports[port](*f_req);
-            periph_fifos.push_back(f_req);
+            monitored_fifos.push_back(f_req);
 
             // Firul 2: Router -> CPU (Response)
-            sc_fifo<packet>* f_rsp = new sc_fifo<packet>(16);
+            stat_fifo<packet>* f_rsp = new stat_fifo<packet>(gen_name("CPU_rsp", id).c_str(), 16);
             routers[r_idx]->out_ports[port](*f_rsp);
             c->in_port(*f_rsp);
-            periph_fifos.push_back(f_rsp);
+            monitored_fifos.push_back(f_rsp);
+
+            topo.add_endpoint(id, r_idx, port);
+            routers[r_idx]->edge_port[port] = true;
         };
 
         // Conectare Memorie la un router
@@ -74,16 +120,20 @@ SC_MODULE(Network) {
             mems.push_back(m);
 
             // Firul 1: Router -> MEM (Request)
-            sc_fifo<packet>* f_req = new sc_fifo<packet>(16);
+            stat_fifo<packet>* f_req = new stat_fifo<packet>(gen_name("MEM_req", id).c_str(), 16);
             routers[r_idx]->out_ports[port](*f_req);
             m->in_port(*f_req);
-            periph_fifos.push_back(f_req);
+            monitored_fifos.push_back(f_req);
 
             // Firul 2: MEM -> Router (Response)
-            sc_fifo<packet>* f_rsp = new sc_fifo<packet>(16);
+            stat_fifo<packet>* f_rsp = new stat_fifo<packet>(gen_name("MEM_rsp", id).c_str(), 16);
             m->out_port(*f_rsp);
             routers[r_idx]->in_ports[port](*f_rsp);
-            periph_fifos.push_back(f_rsp);
+            monitored_fifos.push_back(f_rsp);
+            mem_rsp_fifos.push_back(f_rsp);
+
+            topo.add_endpoint(id, r_idx, port);
+            routers[r_idx]->edge_port[port] = true;
         };
 
         // Închide un port (conectează la nimic/dummy)
@@ -92,11 +142,24 @@ SC_MODULE(Network) {
             sc_fifo<packet>* d2 = new sc_fifo<packet>(16);
             routers[r_idx]->in_ports[port](*d1);
             routers[r_idx]->out_ports[port](*d2);
-            periph_fifos.push_back(d1);
-            periph_fifos.push_back(d2);
+            closed_fifos.push_back(d1);
+            closed_fifos.push_back(d2);
         };
 
-        
+        // Port liber pe routerele din mijloc: urmatorul CPU de stres, daca mai avem, altfel il inchidem
+        int stress_cpus = 0;
+        auto spare_port = [&](int r_idx, int port) {
+            if (stress_cpus >= extra_cpus) {
+                close_port(r_idx, port);
+                return;
+            }
+            stress_cpus++;
+            connect_cpu(r_idx, port, 20 + stress_cpus, (stress_cpus % 2) ? 83 : 200, stress_cpus << 20, 0);
+        };
+
+        // In lant nu folosim portul local, perifericele stau pe N/S/E/V
+        for (int i = 0; i < 8; i++) close_port(i, L);
+
         // IMPLEMENTARE TOPOLOGIE
 
         // ROUTER 1
@@ -106,30 +169,30 @@ SC_MODULE(Network) {
         
 
         // ROUTER 2
-        close_port(1, N); 
-        close_port(1, S);
+        spare_port(1, N); 
+        spare_port(1, S);
 
         // ROUTER 3
-        close_port(2, N); 
-        close_port(2, S); 
+        spare_port(2, N); 
+        spare_port(2, S); 
 
         // ROUTER 4
-        close_port(3, N);
-        close_port(3, S);
+        spare_port(3, N);
+        spare_port(3, S);
         //connect_mem(3, S, 100);
 
         // ROUTER 5
-        close_port(4, N);
-        close_port(4, S);
+        spare_port(4, N);
+        spare_port(4, S);
 
         // ROUTER 6
-        close_port(5, N); 
-        close_port(5, S); 
+        spare_port(5, N); 
+        spare_port(5, S); 
 
         // ROUTER 7
-        close_port(6, N);
+        spare_port(6, N);
         //connect_cpu(6, N, 8, 83, 10, 15);
-        close_port(6, S); 
+        spare_port(6, S); 
 
         // ROUTER 8
         close_port(7, N); 
@@ -174,12 +237,163 @@ SC_MODULE(Network) {
         // close_port(7, N);
         // connect_mem(7, E, 200);
         // close_port(7, S);
+
+        install_routes();
+    }
+
+    sc_time last_stream_end() const {
+        sc_time t = SC_ZERO_TIME;
+        for (size_t i = 0; i < cpus.size(); i++) {
+            if (cpus[i]->stream_end > t) t = cpus[i]->stream_end;
+        }
+        return t;
+    }
+
+    bool all_done() const {
+        for (size_t i = 0; i < cpus.size(); i++) {
+            if (!cpus[i]->stream_done) return false;
+        }
+        return true;
+    }
+
+    // Drumurile minime spre toate perifericele, calculate din topologie si scrise direct in tabelele routerelor.
+    // Nu mai trec prin cfg_port, deci rutele sunt gata inainte de sc_start; cfg_port ramane pentru schimbarile
+    // facute in timpul rularii.
+    void install_routes() {
+        std::vector<std::vector<int8_t> > tables = topo.compute_routes();
+        for (int i = 0; i < 8; i++) {
+            routers[i]->routing_table.clear();
+            routers[i]->routing_table.load(tables[i], 0);
+        }
+        NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [NET] Routes installed: " << (tables.empty() ? 0 : tables[0].size()) << " ids x 8 routers" << endl);
+    }
+
+    // Snapshot al intregii retele la momentul curent: routere, CPU-uri, MEM-uri, toate FIFO-urile si
+    // FIFO-urile de configurare din sc_main (cfg[0..7]). sc_fifo nu are peek, deci FIFO-urile raman goale:
+    // dupa save simularea nu mai poate continua si rularea trebuie oprita.
+    // Se scrie intr-un fisier temporar, redenumit doar la succes: un save esuat nu lasa in urma un snapshot trunchiat
+    // (si nici nu strica unul mai vechi cu acelasi nume).
+    bool save_checkpoint(const std::string& path, sc_fifo<cfg_trans>* cfg) {
+        std::string tmp = path + ".tmp";
+        ckpt_out out(tmp);
+        out.section("NET ");
+        out.time(sc_time_stamp());
+        uint32_t counts[4] = { 8, (uint32_t)cpus.size(), (uint32_t)mems.size(), (uint32_t)(monitored_fifos.size() + closed_fifos.size()) };
+        out.put(counts);
+        for (int i = 0; i < 8; i++) routers[i]->save_state(out);
+        for (size_t i = 0; i < cpus.size(); i++) cpus[i]->save_state(out);
+        for (size_t i = 0; i < mems.size(); i++) mems[i]->save_state(out);
+        out.section("FIFO");
+        for (size_t i = 0; i < monitored_fifos.size(); i++) monitored_fifos[i]->save_state(out);
+        for (size_t i = 0; i < closed_fifos.size(); i++) save_fifo(out, *closed_fifos[i]);
+        for (int i = 0; i < 8; i++) save_fifo(out, cfg[i]);
+        out.section("END ");
+        if (!out.close() || rename(tmp.c_str(), path.c_str()) != 0) {
+            remove(tmp.c_str());
+            NOC_LOG(LOG_ERROR, "[CKPT] ERROR: cannot save " << path << (out.error.empty() ? "" : ": " + out.error) << endl);
+            return false;
+        }
+        NOC_LOG(LOG_INFO, "[CKPT] Saved " << path << " @" << sc_time_stamp() << endl);
+        return true;
+    }
+
+    // Incarca un snapshot salvat de save_checkpoint intr-o retea construita la fel (la elaborare, inainte de sc_start).
+    // Intoarce momentul salvat, de la care continua toate procesele, sau SC_ZERO_TIME daca snapshot-ul nu se potriveste.
+    sc_time load_checkpoint(const std::string& path, sc_fifo<cfg_trans>* cfg) {
+        ckpt_in in(path);
+        in.section("NET ");
+        sc_time at = in.time();
+        uint32_t counts[4];
+        in.raw(counts, sizeof(counts));
+        if (in.ok() && (counts[0] != 8 || counts[1] != cpus.size() || counts[2] != mems.size() ||
+                        counts[3] != monitored_fifos.size() + closed_fifos.size())) {
+            in.fail("checkpoint was saved from a different topology");
+        }
+        if (in.ok() && at == SC_ZERO_TIME) in.fail("checkpoint saved at time 0");
+        for (int i = 0; i < 8 && in.ok(); i++) routers[i]->load_state(in, at);
+        for (size_t i = 0; i < cpus.size() && in.ok(); i++) cpus[i]->load_state(in, at);
+        for (size_t i = 0; i < mems.size() && in.ok(); i++) mems[i]->load_state(in, at);
+        in.section("FIFO");
+        for (size_t i = 0; i < monitored_fifos.size() && in.ok(); i++) monitored_fifos[i]->load_state(in);
+        for (size_t i = 0; i < closed_fifos.size() && in.ok(); i++) load_fifo(in, *closed_fifos[i]);
+        for (int i = 0; i < 8 && in.ok(); i++) load_fifo(in, cfg[i]);
+        in.section("END ");
+        if (!in.ok()) {
+            NOC_LOG(LOG_ERROR, "[CKPT] ERROR: cannot load " << path << ": " << in.error << endl);
+            return SC_ZERO_TIME;
+        }
+        NOC_LOG(LOG_INFO, "[CKPT] Loaded " << path << ", resuming @" << at << endl);
+        return at;
     }
 };
 
 
+// Rulare: ./noc_sim                          -> testul original (un WRITE + un READ)
+//         ./noc_sim <transactions> [window] [burst] [banks] [cpus]
+//              -> CPU 20 trimite <transactions> cereri, cel mult [window] in zbor, fiecare de [burst] cuvinte (wormhole)
+//                 [banks] > 0 activeaza modelul de timing cu banci / row buffer in MEM (0 = 10 ns fix)
+//                 [cpus] > 1 pune inca cpus - 1 CPU-uri (cel mult 12) care fac acelasi lucru, pe rand catre MEM 83 / MEM 200
+//                 (test de stres pentru memorii, vezi Network::spare_port)
+// NOC_MSG_CLASSES=0 leaga reteaua ca inainte, cu cererile si raspunsurile pe aceleasi FIFO-uri (pentru comparatie).
+// Variabilele de mediu NOC_MEM_IMAGE / NOC_MEM_DUMP (cu %d = id-ul memoriei, ex. mem_%d.bin) incarca
+// continutul initial al fiecarei MEM dintr-o imagine, respectiv scriu continutul final la sfarsit.
+// NOC_TRACE=<fisier> (tot cu %d = id-ul CPU-ului) inlocuieste tiparul fix al fiecarui CPU cu cererile dintr-un trace binar
+// (trace.h, vezi bench_trace.cpp): fiecare cerere pleaca la ciclul ei, sau cat de repede permite fereastra cu
+// NOC_TRACE_MODE=closed. [window] ramane numarul maxim de cereri in zbor; [transactions] si [burst] sunt ignorate.
+// NOC_EVENTS=<fisier> inregistreaza evenimentele pachetelor din routere intr-un fisier binar (event_log.h),
+// de analizat cu noc_events (noc_events.cpp).
+// Checkpoint: NOC_CKPT_SAVE=<fisier> + NOC_CKPT_AT=<ns> ruleaza pana la momentul dat, salveaza starea si se opreste;
+// NOC_CKPT_LOAD=<fisier> continua de acolo (argumentele pentru CPU/MEM vin din snapshot, rutele nu se mai configureaza;
+// NOC_TRACE trebuie sa fie acelasi ca la salvare).
+// Numele fisierului pentru o memorie / un CPU: sablonul din variabila de mediu, cu primul %d inlocuit de id ("" daca nu
+// e setata). Sablonul nu e dat la snprintf ca format: orice alt % ramane in nume asa cum e.
+static std::string id_path(const char* env_var, int id) {
+    const char* pattern = getenv(env_var);
+    if (pattern == NULL) return "";
+    std::string path = pattern;
+    size_t at = path.find("%d");
+    if (at != std::string::npos) path.replace(at, 2, std::to_string(id));
+    return path;
+}
+
 int sc_main(int argc, char* argv[]) {
-    Network net("System");
+    int transactions = (argc > 1) ? atoi(argv[1]) : 0;
+    int window = (argc > 2) ? atoi(argv[2]) : 1;
+    int burst = (argc > 3) ? atoi(argv[3]) : 1;
+    int banks = (argc > 4) ? atoi(argv[4]) : 0;
+    int num_cpus = (argc > 5) ? atoi(argv[5]) : 1;
+    bool msg_classes = !(getenv("NOC_MSG_CLASSES") && atoi(getenv("NOC_MSG_CLASSES")) == 0);
+    if (num_cpus < 1 || num_cpus > 13) {
+        cout << "cpus must be between 1 and 13" << endl;
+        return 1;
+    }
+
+    const char* ckpt_save = getenv("NOC_CKPT_SAVE");
+    const char* ckpt_load = getenv("NOC_CKPT_LOAD");
+    double ckpt_at_ns = getenv("NOC_CKPT_AT") ? atof(getenv("NOC_CKPT_AT")) : 0;
+    if (ckpt_save && ckpt_at_ns <= 0) {
+        cout << "NOC_CKPT_SAVE needs NOC_CKPT_AT=<ns> (> 0)" << endl;
+        return 1;
+    }
+
+    Network net("System", num_cpus - 1, msg_classes);
+    for (size_t i = 0; transactions > 0 && i < net.cpus.size(); i++) net.cpus[i]->set_window(transactions, window, burst);
+    if (banks > 0) {
+        for (size_t i = 0; i < net.mems.size(); i++) net.mems[i]->set_timing(BankTiming(banks));
+    }
+    // Redare din trace: fiecare CPU are fisierul lui (sau toti acelasi, daca sablonul nu are %d)
+    bool trace_closed = getenv("NOC_TRACE_MODE") && strcmp(getenv("NOC_TRACE_MODE"), "closed") == 0;
+    sc_time trace_end = SC_ZERO_TIME;
+    for (size_t i = 0; getenv("NOC_TRACE") && i < net.cpus.size(); i++) {
+        CPU* c = net.cpus[i];
+        if (!c->set_trace(id_path("NOC_TRACE", c->my_id), trace_closed, window)) return 1;
+        transactions = std::max(transactions, c->num_transactions);
+        if (!trace_closed && c->trace_cycle * (double)c->trace_last_cycle > trace_end) trace_end = c->trace_cycle * (double)c->trace_last_cycle;
+    }
+    for (size_t i = 0; !ckpt_load && i < net.mems.size(); i++) {
+        std::string image = id_path("NOC_MEM_IMAGE", net.mems[i]->my_id);
+        if (!image.empty()) net.mems[i]->load_image(image);
+    }
 
     // Canale de configurare
     sc_fifo<cfg_trans> cfg_fifos[8];
@@ -187,32 +401,86 @@ int sc_main(int argc, char* argv[]) {
         net.cfg_ports[i](cfg_fifos[i]);
     }
 
+    const sc_time step(1000, SC_NS); // rulam in pasi de 1000 ns si verificam dupa fiecare daca au terminat CPU-urile
+    sc_time first_run = step;
+    if (ckpt_load) {
+        sc_time resume_at = net.load_checkpoint(ckpt_load, cfg_fifos);
+        if (resume_at == SC_ZERO_TIME) return 1;
+        // macar pana la momentul salvat, rotunjit in sus la un pas: pasii (si deci momentul de oprire si statisticile)
+        // sunt aceiasi ca in rularea neintrerupta si cand NOC_CKPT_AT nu e multiplu de 1000 ns
+        if (resume_at > first_run) first_run = step * std::ceil(resume_at / step);
+        transactions = net.cpus[0]->num_transactions;
+        banks = net.mems[0]->banked ? net.mems[0]->timing.num_banks : 0;
+    }
+
+    EventRecorder recorder;
+    if (getenv("NOC_EVENTS")) {
+        if (!recorder.open(getenv("NOC_EVENTS"), net.routers[0]->cycle_time.value())) {
+            cout << "Cannot create " << getenv("NOC_EVENTS") << endl;
+            return 1;
+        }
+        for (int i = 0; i < 8; i++) net.routers[i]->events = recorder.add_router(net.routers[i]->name());
+    }
+
     cout << "--- START L1 SIMULATION ---" << endl;
 
+    if (ckpt_save) {
+        sc_start(ckpt_at_ns, SC_NS);
+        return net.save_checkpoint(ckpt_save, cfg_fifos) ? 0 : 1;
+    }
     
-    // Configurare tabela de rutare pentru MEM 200 spre EST
-    for(int i=0; i<7; i++) cfg_fifos[i].write(cfg_trans(cfg_trans::SET_ROUTE, 200, E));
-    // Routerul 8 scoate 200 pe portul E
-    cfg_fifos[7].write(cfg_trans(cfg_trans::SET_ROUTE, 200, E));
-
-    // Configurare tabela de rutare pentru MEM 200 spre VEST
-    for(int i=1; i<8; i++) cfg_fifos[i].write(cfg_trans(cfg_trans::SET_ROUTE, 20, V));
-    cfg_fifos[0].write(cfg_trans(cfg_trans::SET_ROUTE, 20, V));
-
-    //Configurare MEM 83
-    cfg_fifos[0].write(cfg_trans(cfg_trans::SET_ROUTE, 83, S));
-    for(int i=1; i<8; i++) cfg_fifos[i].write(cfg_trans(cfg_trans::SET_ROUTE, 83, V));
-
-    // Configurare Răspuns pt CPU 8 pana la MEM 83
-    for(int i=0; i<6; i++) cfg_fifos[i].write(cfg_trans(cfg_trans::SET_ROUTE, 8, E));
-    cfg_fifos[6].write(cfg_trans(cfg_trans::SET_ROUTE, 8, N));
-
-    // Configurare MEM 100
-    for(int i=0; i<3; i++) cfg_fifos[i].write(cfg_trans(cfg_trans::SET_ROUTE, 100, E));
-    cfg_fifos[3].write(cfg_trans(cfg_trans::SET_ROUTE, 100, S));
-    
-    sc_start(1000, SC_NS); 
+    // masuram cat dureaza simularea (wall-clock) ca sa comparam router-ul event-driven cu cel cu polling (-DROUTER_POLLING)
+    auto wall_start = std::chrono::steady_clock::now();
+
+    sc_start(first_run);
+
+    // In modul cu fereastra rulam pana termina CPU-urile (cu o limita, in caz ca se pierde un raspuns sau reteaua se blocheaza)
+    // (cu trace cu timpi limita incepe dupa ultima cerere din trace)
+    long max_steps = 10L * transactions + (long)(trace_end / step);
+    for (long i = (long)(first_run / step) - 1; transactions > 0 && !net.all_done() && i < max_steps; i++) {
+        sc_start(step);
+    }
+
+    auto wall_end = std::chrono::steady_clock::now();
+
+    double wall_sec = std::chrono::duration<double>(wall_end - wall_start).count();
+    unsigned long routed = 0;
+    for (int i = 0; i < 8; i++) routed += net.routers[i]->stats.total_routed();
 
     cout << "--- END L1 SIMULATION ---" << endl;
+    cout << "Wall time: " << wall_sec * 1e3 << " ms"
+         << " | Delta cycles: " << sc_delta_count()
+         << " | Packets routed: " << routed << " (" << routed / wall_sec << " pkt/s)" << endl;
+    for (size_t i = 0; banks > 0 && i < net.mems.size(); i++) {
+        MEM* m = net.mems[i];
+        cout << "MEM " << m->my_id << ": " << m->requests << " requests, avg service " << m->avg_service_ns() << " ns, row hits "
+             << m->timing.row_hits << " / misses " << m->timing.row_misses << " (" << banks << " banks)" << endl;
+    }
+
+    if (transactions > 0 && !net.all_done()) NOC_LOG(LOG_ERROR, "ERROR: CPUs did not finish (network deadlock?)" << endl);
+    // Cat a stat fiecare memorie blocata pe out_port.write(raspuns) (cu retele virtuale separate ar trebui sa fie 0)
+    for (size_t i = 0; transactions > 0 && i < net.mems.size(); i++) {
+        MEM* m = net.mems[i];
+        stat_fifo<packet>* f = net.mem_rsp_fifos[i];
+        double cycles = net.last_stream_end() / net.routers[0]->cycle_time;
+        cout << "MEM " << m->my_id << ": " << m->requests << " requests (" << (cycles > 0 ? m->requests / cycles : 0) << " per cycle), "
+             << f->write_stalls << " stalled responses, output full " << f->full_time() / net.routers[0]->cycle_time << " cycles"
+             << (msg_classes ? "" : " (shared request/response links)") << endl;
+    }
+
+    for (size_t i = 0; i < net.mems.size(); i++) {
+        std::string image = id_path("NOC_MEM_DUMP", net.mems[i]->my_id);
+        if (!image.empty()) net.mems[i]->dump_image(image);
+    }
+
+    if (recorder.is_open()) {
+        unsigned long long n = recorder.events();
+        if (recorder.close()) NOC_LOG(LOG_INFO, "[EVENTS] " << n << " events written to " << getenv("NOC_EVENTS") << endl);
+        else NOC_LOG(LOG_ERROR, "[EVENTS] ERROR: writing " << getenv("NOC_EVENTS") << " failed" << endl);
+    }
+
+    // Statistici per router si per FIFO (CSV + JSON)
+    std::vector<Router*> router_list(net.routers, net.routers + 8);
+    dump_stats("l1_stats", router_list, net.monitored_fifos, net.routers[0]->cycle_time);
     return 0;
 }
\ No newline at end of file
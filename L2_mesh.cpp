@@ -0,0 +1,41 @@
+#include <systemc.h>
+#include <cstdlib>
+#include <chrono>
+#include "utils.h"
+#include "mesh.h"
+
+// Level 2: mesh R x C cu rutare XY (fara tabele de rutare programate manual)
+// Rulare: ./mesh_sim [rows] [cols]   (implicit 8 x 8)
+int sc_main(int argc, char* argv[]) {
+    int rows = (argc > 1) ? atoi(argv[1]) : 8;
+    int cols = (argc > 2) ? atoi(argv[2]) : 8;
+
+    if (rows < 2 || cols < 2 || rows > 256 || cols > 256) {
+        cout << "Mesh size must be between 2x2 and 256x256" << endl;
+        return 1;
+    }
+
+    Mesh mesh("Mesh", rows, cols);
+
+    // Doua perechi CPU/MEM pe diagonalele mesh-ului (drumul cel mai lung: (rows-1) + (cols-1) hop-uri)
+    mesh.attach_mem(cols - 1, rows - 1);
+    mesh.attach_cpu(0, 0, xy_id(cols - 1, rows - 1), 10, 83);
+
+    mesh.attach_mem(0, rows - 1);
+    mesh.attach_cpu(cols - 1, 0, xy_id(0, rows - 1), 20, 77);
+
+    cout << "--- START L2 MESH SIMULATION (" << rows << "x" << cols << ", XY routing) ---" << endl;
+
+    auto wall_start = std::chrono::steady_clock::now();
+
+    sc_start(10 * (4 * (rows + cols) + 20), SC_NS);
+
+    auto wall_end = std::chrono::steady_clock::now();
+
+    cout << "--- END L2 MESH SIMULATION ---" << endl;
+    cout << "Wall time: " << std::chrono::duration<double, std::milli>(wall_end - wall_start).count() << " ms"
+         << " | Delta cycles: " << sc_delta_count() << endl;
+
+    mesh.dump_stats("l2_stats");
+    return 0;
+}
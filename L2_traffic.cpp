@@ -0,0 +1,277 @@
+#include <systemc.h>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include "utils.h"
+#include "mesh.h"
+#include "vc_mesh.h"
+#include "traffic.h"
+
+// Level 2: caracterizare load-latency cu trafic sintetic.
+// Pe fiecare router din mesh sta un TrafficGen (sursa + destinatie). Un mesh 1 x N e chiar lantul de routere din L1.
+// Rulare: ./traffic_sim [rows=1] [cols=8] [pattern=uniform] [rate=0.05] [process=bernoulli|poisson]
+//                       [hotspot=x,y] [hot_frac=0.2] [depth=16] [seed=1] [warmup_us=10] [measure_us=50] [drain_us=200]
+//                       [router=basic|vc] [vcs=4] [switch=single|crossbar] [arb=default|priority|rr|oldest|wrr] [stats=l2_traffic_stats|none]
+//                       [routing=xy|west_first|odd_even] [weights=1,1,1,1,1] [topology=mesh|torus] [events=<fisier>]
+// Cu router=vc mesh-ul e construit din VCRouter (vc_mesh.h): depth = pachete per VC, vcs = canale virtuale per legatura.
+// topology=torus (doar router=vc) inchide randurile / coloanele in inel; rows=1 e un inel bidirectional.
+// switch=crossbar pune routerele de baza in modul crossbar (SET_SWITCH), arb alege politica de arbitrare a routerelor.
+// weights = ponderile intrarilor N,S,E,V,L pentru arb=wrr (SET_ARB_WEIGHT), aceleasi pe toate routerele.
+// routing = xy (dimension-order) sau rutare minima adaptiva dupa ocupanta iesirilor (doar router=basic; are sens
+// cu switch=crossbar, routerul single-grant se blocheaza oricum pe o iesire plina).
+// events = inregistreaza evenimentele pachetelor din routere intr-un fisier binar (event_log.h, analiza cu noc_events).
+// stats = prefixul fisierelor cu statistici (none = nu le scriem, ex. cand rulam mai multe simulari in paralel).
+// La final se afiseaza o linie "RESULT key=value ..." usor de parsat de scripturile care fac sweep pe rate.
+
+static int parse_pattern(const char* s) {
+    for (int i = 0; i <= TRAFFIC_NEIGHBOUR; i++) {
+        if (strcmp(s, TrafficPatternNames[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Numele modurilor de rutare in linia de comanda si in RESULT (indexate cu RouteMode)
+static const char* routing_names[] = { "table", "xy", "west_first", "odd_even" };
+
+static int parse_routing(const char* s) {
+    for (int i = ROUTE_XY; i <= ROUTE_ODD_EVEN; i++) {
+        if (strcmp(s, routing_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Numele politicilor de arbitrare in linia de comanda si in RESULT (indexate cu ArbMode)
+static const char* arb_names[] = { "priority", "rr", "oldest", "wrr" };
+
+static int parse_arb(const char* s) {
+    if (strcmp(s, "round_robin") == 0) return ROUND_ROBIN;
+    for (int i = PRIORITY; i <= WEIGHTED_RR; i++) {
+        if (strcmp(s, arb_names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// Warmup + masura + drain pe un mesh deja construit (Mesh sau VCMesh) si raportul final
+template <class M>
+int run(M& mesh, const TrafficConfig& tcfg, double drain_us, const char* router_name, const std::string& router_desc,
+        int depth, int arb, const int weights[], int routing, const char* topology, const std::string& events_path,
+        const std::string& stats_prefix) {
+    int rows = mesh.rows, cols = mesh.cols;
+    for (size_t i = 0; i < mesh.routers.size(); i++) {
+        mesh.routers[i]->arbitration_policy = arb;
+        mesh.routers[i]->routing_mode = routing;
+        for (int p = 0; p < NUM_PORTS; p++) mesh.routers[i]->arb_weight[p] = weights[p];
+    }
+    mesh.attach_traffic_all(tcfg);
+
+    EventRecorder recorder;
+    if (!events_path.empty()) {
+        if (!recorder.open(events_path, mesh.routers[0]->cycle_time.value())) {
+            cout << "Cannot create " << events_path << endl;
+            return 1;
+        }
+        for (size_t i = 0; i < mesh.routers.size(); i++) mesh.routers[i]->events = recorder.add_router(mesh.routers[i]->name());
+    }
+
+    int nodes = rows * cols;
+    const char* proc_name = (tcfg.process == INJECT_POISSON) ? "poisson" : "bernoulli";
+    cout << "--- START L2 TRAFFIC (" << rows << "x" << cols << ", " << router_desc << ", " << TrafficPatternNames[tcfg.pattern]
+         << ", " << routing_names[routing] << ", " << proc_name << ", rate " << tcfg.rate << " pkt/cycle/node) ---" << endl;
+
+    auto wall_start = std::chrono::steady_clock::now();
+
+    // Warmup + fereastra de masura
+    sc_start(tcfg.warmup + tcfg.measure);
+
+    // Drain: generatoarele continua sa injecteze (ca pachetele masurate sa vada aceeasi sarcina),
+    // pana cand toate pachetele din fereastra au ajuns sau expira drain_us (retea saturata)
+    sc_time drain_end = sc_time_stamp() + sc_time(drain_us, SC_US);
+    bool drained = false;
+    while (sc_time_stamp() < drain_end) {
+        unsigned long gen = 0, rcv = 0;
+        for (size_t i = 0; i < mesh.traffic.size(); i++) {
+            gen += mesh.traffic[i]->measured_generated;
+            rcv += mesh.traffic[i]->measured_received;
+        }
+        if (rcv == gen) { drained = true; break; }
+        sc_start(tcfg.cycle * 100);
+    }
+    for (size_t i = 0; i < mesh.traffic.size(); i++) mesh.traffic[i]->stop();
+
+    auto wall_end = std::chrono::steady_clock::now();
+
+    // Agregare peste toate nodurile
+    LatencyStats lat;
+    unsigned long gen = 0, rcv = 0, window_rcv = 0, backlog = 0;
+    for (size_t i = 0; i < mesh.traffic.size(); i++) {
+        TrafficGen* t = mesh.traffic[i];
+        lat.merge(t->latency);
+        gen += t->measured_generated;
+        rcv += t->measured_received;
+        window_rcv += t->window_received;
+        backlog += t->source_queue_len();
+    }
+    // Hop-uri medii: treceri pe legaturi router-router per pachet livrat (pe toata simularea, nu doar in fereastra)
+    unsigned long link_hops = 0, delivered = 0;
+    for (size_t i = 0; i < mesh.routers.size(); i++) {
+        const RouterStats& s = mesh.routers[i]->stats;
+        for (int in = 0; in < NUM_PORTS; in++) {
+            for (int out = 0; out < L; out++) link_hops += s.forwarded[in][out];
+            delivered += s.forwarded[in][L];
+        }
+    }
+    double avg_hops = delivered ? (double)link_hops / delivered : 0;
+
+    double window_cycles = tcfg.measure / tcfg.cycle;
+    double offered = gen / (window_cycles * nodes);
+    double accepted = window_rcv / (window_cycles * nodes);
+
+    cout << "--- END L2 TRAFFIC ---" << endl;
+    cout << "Measured packets: " << rcv << "/" << gen << (drained ? "" : " (NOT drained: network saturated)")
+         << " | Source backlog: " << backlog << endl;
+    cout << "Offered: " << offered << " | Accepted: " << accepted << " pkt/cycle/node"
+         << " | Latency avg " << lat.avg() << " p99 " << lat.percentile(99) << " max " << lat.max() << " cycles"
+         << " | Avg hops " << avg_hops << endl;
+    cout << "Wall time: " << std::chrono::duration<double, std::milli>(wall_end - wall_start).count() << " ms"
+         << " | Delta cycles: " << sc_delta_count() << endl;
+
+    printf("RESULT router=%s rows=%d cols=%d pattern=%s process=%s rate=%g offered=%.6f accepted=%.6f "
+           "avg_lat=%.3f p99_lat=%.3f max_lat=%.3f measured=%lu received=%lu drained=%d depth=%d arb=%s routing=%s "
+           "topology=%s avg_hops=%.3f\n",
+           router_name, rows, cols, TrafficPatternNames[tcfg.pattern], proc_name, tcfg.rate, offered, accepted,
+           lat.avg(), lat.percentile(99), lat.max(), gen, rcv, drained ? 1 : 0, depth, arb_names[arb], routing_names[routing],
+           topology, avg_hops);
+    fflush(stdout);
+
+    if (recorder.is_open()) {
+        unsigned long long n = recorder.events();
+        if (recorder.close()) cout << "Events: " << n << " written to " << events_path << endl;
+        else cout << "ERROR: writing " << events_path << " failed" << endl;
+    }
+
+    if (stats_prefix != "none") mesh.dump_stats(stats_prefix);
+    return 0;
+}
+
+int sc_main(int argc, char* argv[]) {
+    int rows = 1, cols = 8, depth = 16, vcs = 4;
+    std::string router_name = "basic";
+    std::string topology = "mesh";
+    int switch_mode = SWITCH_SINGLE;
+    int routing = ROUTE_XY;
+    int arb = -1; // implicit: politica implicita a routerului (PRIORITY pentru basic, ROUND_ROBIN pentru vc)
+    int weights[NUM_PORTS] = { 1, 1, 1, 1, 1 };
+    std::string stats_prefix = "l2_traffic_stats";
+    std::string events_path;
+    int hot_x = -1, hot_y = -1;
+    double warmup_us = 10, measure_us = 50, drain_us = 200;
+    TrafficConfig tcfg;
+    tcfg.rate = 0.05;
+
+    for (int i = 1; i < argc; i++) {
+        const char* eq = strchr(argv[i], '=');
+        if (eq == NULL) {
+            cout << "Bad argument '" << argv[i] << "' (expected key=value)" << endl;
+            return 1;
+        }
+        std::string key(argv[i], eq - argv[i]);
+        const char* val = eq + 1;
+
+        if (key == "rows") rows = atoi(val);
+        else if (key == "cols") cols = atoi(val);
+        else if (key == "depth") depth = atoi(val);
+        else if (key == "vcs") vcs = atoi(val);
+        else if (key == "router") router_name = val;
+        else if (key == "topology") {
+            topology = val;
+            if (topology != "mesh" && topology != "torus") {
+                cout << "Unknown topology '" << val << "'" << endl;
+                return 1;
+            }
+        }
+        else if (key == "switch") switch_mode = (strcmp(val, "crossbar") == 0) ? SWITCH_CROSSBAR : SWITCH_SINGLE;
+        else if (key == "arb") {
+            arb = (strcmp(val, "default") == 0) ? -1 : parse_arb(val);
+            if (arb < 0 && strcmp(val, "default") != 0) {
+                cout << "Unknown arbiter '" << val << "'" << endl;
+                return 1;
+            }
+        }
+        else if (key == "weights") {
+            int n = sscanf(val, "%d,%d,%d,%d,%d", &weights[N], &weights[S], &weights[E], &weights[V], &weights[L]);
+            if (n != NUM_PORTS || *std::min_element(weights, weights + NUM_PORTS) < 1) {
+                cout << "weights must be 5 positive integers (N,S,E,V,L)" << endl;
+                return 1;
+            }
+        }
+        else if (key == "stats") stats_prefix = val;
+        else if (key == "events") events_path = val;
+        else if (key == "routing") {
+            routing = parse_routing(val);
+            if (routing < 0) {
+                cout << "Unknown routing '" << val << "'" << endl;
+                return 1;
+            }
+        }
+        else if (key == "rate") tcfg.rate = atof(val);
+        else if (key == "seed") tcfg.seed = (unsigned)atoi(val);
+        else if (key == "hot_frac") tcfg.hotspot_frac = atof(val);
+        else if (key == "warmup_us") warmup_us = atof(val);
+        else if (key == "measure_us") measure_us = atof(val);
+        else if (key == "drain_us") drain_us = atof(val);
+        else if (key == "hotspot") sscanf(val, "%d,%d", &hot_x, &hot_y);
+        else if (key == "process") tcfg.process = (strcmp(val, "poisson") == 0) ? INJECT_POISSON : INJECT_BERNOULLI;
+        else if (key == "pattern") {
+            tcfg.pattern = parse_pattern(val);
+            if (tcfg.pattern < 0) {
+                cout << "Unknown pattern '" << val << "'" << endl;
+                return 1;
+            }
+        } else {
+            cout << "Unknown parameter '" << key << "'" << endl;
+            return 1;
+        }
+    }
+
+    if (rows < 1 || cols < 1 || rows > 256 || cols > 256 || rows * cols < 2) {
+        cout << "Mesh size must be between 1x2 and 256x256" << endl;
+        return 1;
+    }
+
+    if (hot_x < 0 || hot_y < 0) { hot_x = cols / 2; hot_y = rows / 2; } // implicit: centrul mesh-ului
+    tcfg.hotspot_id = xy_id(hot_x % cols, hot_y % rows);
+    tcfg.warmup = sc_time(warmup_us, SC_US);
+    tcfg.measure = sc_time(measure_us, SC_US);
+
+    if (topology == "torus" && router_name != "vc") {
+        cout << "topology=torus needs router=vc (dateline deadlock avoidance uses the VCs)" << endl;
+        return 1;
+    }
+
+    if (router_name == "vc") {
+        if (vcs < 1) {
+            cout << "vcs must be at least 1" << endl;
+            return 1;
+        }
+        if (topology == "torus" && vcs < 2) {
+            cout << "topology=torus needs vcs >= 2 (two dateline classes)" << endl;
+            return 1;
+        }
+        if (routing != ROUTE_XY) {
+            cout << "Adaptive routing needs router=basic (VCRouter only supports XY)" << endl;
+            return 1;
+        }
+        VCMesh mesh("Mesh", rows, cols, vcs, depth, 16, topology == "torus");
+        if (arb < 0) arb = mesh.routers[0]->arbitration_policy;
+        return run(mesh, tcfg, drain_us, "vc", std::to_string(vcs) + " VC x " + std::to_string(depth) + (topology == "torus" ? ", torus" : ""), depth, arb, weights,
+                   routing, topology.c_str(), events_path, stats_prefix);
+    }
+    Mesh mesh("Mesh", rows, cols, depth);
+    if (arb < 0) arb = mesh.routers[0]->arbitration_policy;
+    for (size_t i = 0; i < mesh.routers.size(); i++) mesh.routers[i]->switch_mode = switch_mode;
+    if (switch_mode == SWITCH_CROSSBAR) return run(mesh, tcfg, drain_us, "crossbar", "crossbar router", depth, arb, weights, routing, "mesh", events_path, stats_prefix);
+    return run(mesh, tcfg, drain_us, "basic", "basic router", depth, arb, weights, routing, "mesh", events_path, stats_prefix);
+}
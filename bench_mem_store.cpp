@@ -0,0 +1,152 @@
+// Microbenchmark: PagedStore (pagini + director plat) vs std::map<int,int> (vechea memorie din MEM),
+// latenta medie din modelul de timing cu banci pentru cateva tipare de adrese, si pornirea "calda"
+// dintr-o imagine mapata cu mmap vs aceleasi date scrise cuvant cu cuvant.
+// Nu are nevoie de SystemC:
+//   g++ -O2 -o bench_mem_store bench_mem_store.cpp && ./bench_mem_store
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include "mem_store.h"
+
+using namespace std;
+
+static const int ACCESSES = 10000000;
+
+// Exact ce facea MEM inainte: scriere cu operator[], citire cu find() + operator[]
+static long run_map(const vector<int>& addrs) {
+    map<int, int> mem;
+    long sum = 0;
+    for (int i = 0; i < ACCESSES; i++) {
+        int a = addrs[i & (addrs.size() - 1)];
+        if (i & 1) {
+            if (mem.find(a) != mem.end()) sum += mem[a];
+        } else {
+            mem[a] = i;
+        }
+    }
+    return sum;
+}
+
+static long run_paged(const vector<int>& addrs, size_t& host_bytes) {
+    PagedStore mem;
+    long sum = 0;
+    for (int i = 0; i < ACCESSES; i++) {
+        int a = addrs[i & (addrs.size() - 1)];
+        if (i & 1) {
+            if (mem.is_mapped(a)) sum += mem.read(a);
+        } else {
+            mem.write(a, i);
+        }
+    }
+    host_bytes = mem.host_bytes();
+    return sum;
+}
+
+template <typename F>
+static double maccesses_per_sec(F f, long& checksum) {
+    auto t0 = chrono::steady_clock::now();
+    checksum = f();
+    auto t1 = chrono::steady_clock::now();
+    return ACCESSES / chrono::duration<double>(t1 - t0).count() / 1e6;
+}
+
+// Cereri care sosesc la fiecare interval ns: latenta medie (gata - sosire) pentru un tipar de adrese
+static double avg_latency(BankTiming t, const vector<int>& addrs, double interval) {
+    double sum = 0;
+    for (size_t i = 0; i < addrs.size(); i++) {
+        double now = i * interval;
+        sum += t.access(addrs[i], 1, now) - now;
+    }
+    return sum / addrs.size();
+}
+
+int main() {
+    mt19937 rng(1);
+
+    // 1) Throughput pe host: jumatate scrieri, jumatate citiri, pe un set de adrese de marime data
+    cout << setw(12) << "addresses" << setw(10) << "pattern" << setw(14) << "map [M/s]" << setw(14) << "paged [M/s]"
+         << setw(10) << "speedup" << setw(16) << "paged host MB" << endl;
+    for (int span_log : {16, 20, 24}) {
+        for (int random_order = 0; random_order <= 1; random_order++) {
+            // 1M accese (putere a lui 2) peste 2^span_log adrese: fie secvential, fie aleator
+            vector<int> addrs(1 << 20);
+            uniform_int_distribution<int> pick(0, (1 << span_log) - 1);
+            for (size_t i = 0; i < addrs.size(); i++) {
+                addrs[i] = random_order ? pick(rng) : (int)((i * 7) & ((1u << span_log) - 1));
+            }
+
+            long c1, c2;
+            size_t paged_bytes = 0;
+            double r_map = maccesses_per_sec([&] { return run_map(addrs); }, c1);
+            double r_paged = maccesses_per_sec([&] { return run_paged(addrs, paged_bytes); }, c2);
+            if (c1 != c2) {
+                cout << "MISMATCH between map and paged store!" << endl;
+                return 1;
+            }
+            cout << setw(12) << (1 << span_log) << setw(10) << (random_order ? "random" : "strided")
+                 << setw(14) << fixed << setprecision(1) << r_map << setw(14) << r_paged
+                 << setw(9) << r_paged / r_map << "x" << setw(16) << paged_bytes / 1048576.0 << endl;
+        }
+    }
+
+    // 2) Modelul de timing: o cerere la 12 ns (o banca tine pasul doar cu row hits de 10 ns)
+    cout << endl << setw(22) << "address pattern" << setw(14) << "1 bank [ns]" << setw(14) << "8 banks [ns]" << endl;
+    const int N = 100000;
+    vector<int> seq(N), row_stride(N), same_bank(N), rnd(N);
+    uniform_int_distribution<int> any(0, (1 << 24) - 1);
+    for (int i = 0; i < N; i++) {
+        seq[i] = i;                    // acelasi rand cat mai mult: row hits
+        row_stride[i] = i * 256;       // rand nou la fiecare cerere, pe banci diferite
+        same_bank[i] = i * 256 * 8;    // rand nou la fiecare cerere, mereu aceeasi banca
+        rnd[i] = any(rng);
+    }
+    struct { const char* name; const vector<int>* a; } pats[] = {
+        { "sequential", &seq }, { "row stride", &row_stride }, { "bank conflict", &same_bank }, { "random", &rnd }
+    };
+    for (auto& p : pats) {
+        cout << setw(22) << p.name;
+        for (int banks : {1, 8}) {
+            // daca bancile nu tin pasul, coada creste la nesfarsit si media depinde doar de N
+            double lat = avg_latency(BankTiming(banks), *p.a, 12.0);
+            if (lat > 1000) cout << setw(14) << "saturated";
+            else cout << setw(14) << setprecision(1) << lat;
+        }
+        cout << endl;
+    }
+
+    // 3) Warm start: 64M cuvinte (256 MB) incarcate din imagine vs scrise unul cate unul
+    const int IMG_WORDS = 64 << 20;
+    const char* img = "bench_mem_store.img";
+    double t_write, t_load;
+    {
+        PagedStore src;
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < IMG_WORDS; i++) src.write(i, i ^ 0x5a5a);
+        t_write = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        int base;
+        if (src.dump_image(img, base) != IMG_WORDS || base != 0) {
+            cout << "Cannot write " << img << endl;
+            return 1;
+        }
+    }
+    PagedStore warm;
+    auto t0 = chrono::steady_clock::now();
+    long loaded = warm.load_image(img, 0);
+    t_load = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    bool ok = loaded == IMG_WORDS;
+    for (int i = 0; ok && i < IMG_WORDS; i += 9973) ok = warm.read(i) == (i ^ 0x5a5a);
+    warm.write(0, -1); // copy-on-write: fisierul ramane neschimbat
+    remove(img);
+    if (!ok) {
+        cout << "MISMATCH after load_image!" << endl;
+        return 1;
+    }
+    cout << endl << "Warm start, " << IMG_WORDS / (1 << 20) << "M words: write loop " << setprecision(1) << t_write
+         << " ms, load_image " << setprecision(3) << t_load << " ms (" << warm.pages_mapped() << " pages mapped, "
+         << warm.pages_allocated() << " copied)" << endl;
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Microbenchmark: RouteTable (vector dens) vs std::map<int,int> (vechea tabela din Router),
+// plus timpul de calcul al rutelor minime din Topology pe mesh-uri mari
+// Nu are nevoie de SystemC:
+//   g++ -O2 -o bench_route_table bench_route_table.cpp && ./bench_route_table
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <vector>
+#include <random>
+#include <chrono>
+#include "route_table.h"
+#include "noc_types.h"
+#include "topology.h"
+
+using namespace std;
+
+static const int LOOKUPS = 20000000;
+
+// Exact ce facea Router::process inainte: find() + operator[] (doua cautari in arbore)
+static long run_map(const map<int, int>& table_in, const vector<int>& dsts) {
+    map<int, int> table = table_in;
+    long sum = 0;
+    for (int i = 0; i < LOOKUPS; i++) {
+        int d = dsts[i & (dsts.size() - 1)];
+        if (table.find(d) != table.end()) sum += table[d];
+        else sum -= 1;
+    }
+    return sum;
+}
+
+static long run_dense(const RouteTable& table, const vector<int>& dsts) {
+    long sum = 0;
+    for (int i = 0; i < LOOKUPS; i++) {
+        int out = table.lookup(dsts[i & (dsts.size() - 1)]);
+        if (out != RouteTable::NO_ROUTE) sum += out;
+        else sum -= 1;
+    }
+    return sum;
+}
+
+template <typename F>
+static double mlookups_per_sec(F f, long& checksum) {
+    auto t0 = chrono::steady_clock::now();
+    checksum = f();
+    auto t1 = chrono::steady_clock::now();
+    return LOOKUPS / chrono::duration<double>(t1 - t0).count() / 1e6;
+}
+
+// Mesh k x k cu cate un periferic pe portul local al fiecarui router (id = indexul routerului).
+// Masoara compute_routes() si verifica ca fiecare drum are exact |dx| + |dy| hop-uri.
+static bool bench_topology(int k) {
+    Topology topo(k * k);
+    for (int y = 0; y < k; y++) {
+        for (int x = 0; x < k; x++) {
+            int r = y * k + x;
+            if (x + 1 < k) { topo.add_link(r, E, r + 1); topo.add_link(r + 1, V, r); }
+            if (y + 1 < k) { topo.add_link(r, S, r + k); topo.add_link(r + k, N, r); }
+            topo.add_endpoint(r, r, L);
+        }
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    vector<vector<int8_t> > tables = topo.compute_routes();
+    auto t1 = chrono::steady_clock::now();
+
+    mt19937 rng(k);
+    uniform_int_distribution<int> pick(0, k * k - 1);
+    for (int i = 0; i < 10000; i++) {
+        int src = pick(rng), dst = pick(rng);
+        int r = src, hops = 0;
+        while (tables[r][dst] != L) {
+            int p = tables[r][dst];
+            r += (p == E) ? 1 : (p == V) ? -1 : (p == S) ? k : -k;
+            if (++hops > 2 * k) return false;
+        }
+        if (r != dst || hops != abs(src % k - dst % k) + abs(src / k - dst / k)) return false;
+    }
+    cout << setw(10) << (to_string(k) + "x" + to_string(k)) << setw(16) << fixed << setprecision(2)
+         << chrono::duration<double, milli>(t1 - t0).count() << endl;
+    return true;
+}
+
+int main() {
+    mt19937 rng(1);
+    cout << setw(10) << "routes" << setw(16) << "map [M/s]" << setw(16) << "dense [M/s]" << setw(10) << "speedup" << endl;
+
+    // de la cateva rute (L1) pana la un mesh 16x16 cu id-uri codificate pe coordonate
+    for (int n_routes : {8, 64, 256, 4096}) {
+        map<int, int> m;
+        RouteTable t;
+        uniform_int_distribution<int> id(0, RouteTable::MAX_ID - 1), port(0, 3);
+        vector<int> ids;
+        while ((int)ids.size() < n_routes) {
+            int d = id(rng);
+            if (m.count(d)) continue;
+            int p = port(rng);
+            m[d] = p;
+            t.set(d, p);
+            ids.push_back(d);
+        }
+
+        // 1M destinatii (putere a lui 2), majoritatea cu ruta, cateva fara
+        vector<int> dsts(1 << 20);
+        uniform_int_distribution<int> pick(0, n_routes - 1);
+        for (size_t i = 0; i < dsts.size(); i++) dsts[i] = (i % 16 == 0) ? id(rng) : ids[pick(rng)];
+
+        long c1, c2;
+        double r_map = mlookups_per_sec([&] { return run_map(m, dsts); }, c1);
+        double r_dense = mlookups_per_sec([&] { return run_dense(t, dsts); }, c2);
+        if (c1 != c2) {
+            cout << "MISMATCH between map and dense table!" << endl;
+            return 1;
+        }
+        cout << setw(10) << n_routes << setw(16) << fixed << setprecision(1) << r_map
+             << setw(16) << r_dense << setw(9) << setprecision(1) << r_dense / r_map << "x" << endl;
+    }
+
+    cout << endl << setw(10) << "mesh" << setw(16) << "routes [ms]" << endl;
+    for (int k : {8, 16, 32, 64}) {
+        if (!bench_topology(k)) {
+            cout << "NON-MINIMAL route in " << k << "x" << k << " mesh!" << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+// Trace-uri binare (trace.h): genereaza un trace de cereri, apoi il citeste cu TraceReader in ambele moduri
+// (pread pe blocuri si mmap) si masoara viteza si memoria rezidenta maxima a procesului.
+// Nu are nevoie de SystemC:
+//   g++ -O2 -o bench_trace bench_trace.cpp
+//   ./bench_trace [records=20000000] [file=bench.trc] [gap=2] [dst=83,200] [keep=0]
+// Cererile urmeaza tiparul din CPU::stream: WRITE urmat de READ la aceeasi adresa, o cerere la fiecare gap cicluri,
+// perechile pe rand catre memoriile din dst. Cu keep=1 fisierul ramane pe disc si poate fi redat in L1:
+//   NOC_TRACE=bench.trc ./noc_sim 0 8
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+#include "trace.h"
+
+using namespace std;
+
+static double peak_rss_mb() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss / 1024.0;
+}
+
+// Citeste tot trace-ul; intoarce milioane de inregistrari pe secunda (checksum ca sa nu dispara bucla)
+static double read_all(const string& path, TraceReader::Mode mode, uint64_t& checksum, const char*& used) {
+    TraceReader r;
+    if (!r.open(path, mode)) {
+        cout << "ERROR: " << r.error << endl;
+        exit(1);
+    }
+    used = (r.active_mode() == TraceReader::MMAP) ? "mmap" : "chunked";
+    auto t0 = chrono::steady_clock::now();
+    trace_record rec;
+    checksum = 0;
+    while (r.next(rec)) checksum += rec.cycle ^ (uint32_t)rec.address ^ (uint32_t)rec.dst_id;
+    auto t1 = chrono::steady_clock::now();
+    return r.size() / chrono::duration<double>(t1 - t0).count() / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t records = 20000000;
+    string path = "bench.trc";
+    uint64_t gap = 2;
+    vector<int> dst = { 83, 200 };
+    bool keep = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* eq = strchr(argv[i], '=');
+        if (eq == NULL) {
+            cout << "Bad argument '" << argv[i] << "' (expected key=value)" << endl;
+            return 1;
+        }
+        string key(argv[i], eq - argv[i]);
+        const char* val = eq + 1;
+        if (key == "records") records = strtoull(val, NULL, 10);
+        else if (key == "file") path = val;
+        else if (key == "gap") gap = strtoull(val, NULL, 10);
+        else if (key == "keep") keep = atoi(val) != 0;
+        else if (key == "dst") {
+            dst.clear();
+            for (const char* p = val; *p; ) {
+                dst.push_back(atoi(p));
+                p = strchr(p, ',');
+                if (p == NULL) break;
+                p++;
+            }
+        } else {
+            cout << "Unknown parameter '" << key << "'" << endl;
+            return 1;
+        }
+    }
+    if (dst.empty()) {
+        cout << "dst needs at least one memory id" << endl;
+        return 1;
+    }
+
+    // 1. Generare
+    auto t0 = chrono::steady_clock::now();
+    TraceWriter w;
+    if (!w.open(path)) {
+        cout << "ERROR: cannot create " << path << endl;
+        return 1;
+    }
+    for (uint64_t k = 0; k < records; k++) {
+        trace_record rec;
+        rec.cycle = k * gap;
+        rec.type = (k % 2 == 0) ? TRACE_WRITE : TRACE_READ;
+        rec.dst_id = dst[(k / 2) % dst.size()];
+        rec.address = 10 + (int32_t)(k / 2);
+        rec.data = (k % 2 == 0) ? 83 + (int32_t)(k / 2) : 0;
+        w.append(rec);
+    }
+    if (!w.close()) {
+        cout << "ERROR: writing " << path << " failed (disk full?)" << endl;
+        return 1;
+    }
+    double write_s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    double mb = (TRACE_HEADER_BYTES + records * sizeof(trace_record)) / 1048576.0;
+
+    cout << fixed << setprecision(1);
+    cout << "--- TRACE: " << records << " records, " << mb << " MB, " << path << " ---" << endl;
+    cout << setw(10) << "write" << setw(12) << records / write_s / 1e6 << " M rec/s" << setw(10) << peak_rss_mb() << " MB peak RSS" << endl;
+
+    // 2. Citire: intai pe blocuri, apoi mmap (RSS-ul maxim nu scade, deci ordinea conteaza pentru masuratoare)
+    TraceReader::Mode modes[2] = { TraceReader::CHUNKED, TraceReader::MMAP };
+    uint64_t sums[2];
+    for (int m = 0; m < 2; m++) {
+        const char* used = "";
+        double rate = read_all(path, modes[m], sums[m], used);
+        cout << setw(10) << used << setw(12) << rate << " M rec/s" << setw(10) << peak_rss_mb() << " MB peak RSS" << endl;
+    }
+    if (sums[0] != sums[1]) {
+        cout << "ERROR: chunked and mmap readers disagree" << endl;
+        return 1;
+    }
+
+    if (!keep) remove(path.c_str());
+    return 0;
+}
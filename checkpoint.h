@@ -0,0 +1,186 @@
+// checkpoint.h
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <systemc.h>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "utils.h"
+
+// Snapshot binar al starii simularii (checkpoint): o succesiune de valori in ordinea de octeti a host-ului,
+// scrise de save_state() si citite de load_state() ale fiecarui modul, in aceeasi ordine.
+// Fiecare bloc incepe cu un marcaj de 4 caractere, ca sa prindem repede un snapshot care nu se potriveste
+// cu reteaua construita. Timpii sunt salvati ca sc_time::value(), deci resolutia de timp trebuie sa fie aceeasi.
+//
+// Reluarea: reteaua se construieste la fel, load_state() se apeleaza inainte de sc_start, iar fiecare proces
+// asteapta pana la momentul salvat (resume_at) si continua de acolo. Simularea porneste tot de la 0, dar pana la
+// resume_at nu se intampla nimic (un singur eveniment temporizat per proces), deci warm-up-ul nu se mai simuleaza.
+
+// Ultima cifra e versiunea formatului (2: legaturile isi salveaza si capacitatea si contoarele de FIFO plin;
+// 3: routerele isi salveaza si ponderile / runda curenta a arbitrului WEIGHTED_RR; 4: registrele routerelor sunt pe lane,
+// cu reteaua de raspunsuri; 5: CPU-urile isi salveaza modul trace-ului si intarzierile lui, pozitia in trace vine din issued;
+// 6: routerele isi salveaza si intrarea pachetului blocat pe o iesire plina, pentru evenimentul FORWARD)
+static const char CKPT_MAGIC[8] = { 'N', 'O', 'C', 'C', 'K', 'P', 'T', '6' };
+
+class ckpt_out {
+public:
+    explicit ckpt_out(const std::string& path) : f(fopen(path.c_str(), "wb")), failed(f == NULL) {
+        raw(CKPT_MAGIC, sizeof(CKPT_MAGIC));
+    }
+    ~ckpt_out() { close(); }
+
+    // Intoarce false daca vreo scriere a esuat (disc plin etc.)
+    bool close() {
+        if (f && fclose(f) != 0) failed = true;
+        f = NULL;
+        return !failed;
+    }
+
+    bool ok() const { return !failed; }
+
+    // Marcheaza o eroare de continut (ex. o stare care nu poate fi salvata)
+    void fail(const std::string& why) {
+        if (error.empty()) error = why;
+        failed = true;
+    }
+    std::string error;
+
+    void raw(const void* p, size_t n) {
+        if (f && !failed && fwrite(p, 1, n, f) != n) failed = true;
+    }
+
+    template <class T> void put(const T& v) { raw(&v, sizeof(T)); }
+
+    void section(const char* tag) { raw(tag, 4); }
+
+    void time(const sc_time& t) { put<uint64_t>(t.value()); }
+
+    void pkt(const packet& p) {
+        int32_t v[8] = { p.type, p.src_id, p.dst_id, p.address, p.data, p.tag, p.flit, p.len };
+        raw(v, sizeof(v));
+        time(p.inject_time);
+    }
+
+    void cfg(const cfg_trans& c) {
+        if (c.table) fail("LOAD_TABLE transactions cannot be saved"); // tabela e doar un pointer
+        int32_t v[4] = { c.type, c.target, c.value, c.aux };
+        raw(v, sizeof(v));
+    }
+
+    template <class T> void items(const std::vector<T>& v) {
+        put<uint32_t>((uint32_t)v.size());
+        if (!v.empty()) raw(v.data(), v.size() * sizeof(T));
+    }
+
+private:
+    FILE* f;
+    bool failed;
+};
+
+class ckpt_in {
+public:
+    explicit ckpt_in(const std::string& path) : f(fopen(path.c_str(), "rb")), failed(f == NULL) {
+        if (failed) {
+            error = "cannot open " + path;
+            return;
+        }
+        char magic[sizeof(CKPT_MAGIC)];
+        raw(magic, sizeof(magic));
+        if (!failed && memcmp(magic, CKPT_MAGIC, sizeof(magic)) != 0) fail(path + " is not a checkpoint");
+    }
+    ~ckpt_in() {
+        if (f) fclose(f);
+    }
+
+    bool ok() const { return !failed; }
+
+    void fail(const std::string& why) {
+        if (error.empty()) error = why;
+        failed = true;
+    }
+    std::string error;
+
+    void raw(void* p, size_t n) {
+        if (failed) {
+            memset(p, 0, n);
+        } else if (fread(p, 1, n, f) != n) {
+            memset(p, 0, n);
+            fail("checkpoint truncated");
+        }
+    }
+
+    template <class T> T get() {
+        T v;
+        raw(&v, sizeof(T));
+        return v;
+    }
+
+    // Verifica marcajul blocului urmator (false + eroare daca nu e cel asteptat)
+    bool section(const char* tag) {
+        char t[4];
+        raw(t, 4);
+        if (!failed && memcmp(t, tag, 4) != 0) fail(std::string("expected section ") + std::string(tag, 4) + ", found " + std::string(t, 4));
+        return !failed;
+    }
+
+    sc_time time() { return sc_time::from_value(get<uint64_t>()); }
+
+    packet pkt() {
+        int32_t v[8];
+        raw(v, sizeof(v));
+        packet p((packet::Type)v[0], v[1], v[2], v[3], v[4], v[5]);
+        p.flit = v[6];
+        p.len = v[7];
+        p.inject_time = time();
+        return p;
+    }
+
+    cfg_trans cfg() {
+        int32_t v[4];
+        raw(v, sizeof(v));
+        return cfg_trans(v[0], v[1], v[2], v[3]);
+    }
+
+    template <class T> void items(std::vector<T>& v) {
+        uint32_t n = get<uint32_t>();
+        if (failed) n = 0;
+        v.resize(n);
+        if (n) raw(v.data(), n * sizeof(T));
+    }
+
+private:
+    FILE* f;
+    bool failed;
+};
+
+inline void ckpt_item(ckpt_out& out, const packet& p) { out.pkt(p); }
+inline void ckpt_item(ckpt_out& out, const cfg_trans& c) { out.cfg(c); }
+inline void ckpt_item(ckpt_in& in, packet& p) { p = in.pkt(); }
+inline void ckpt_item(ckpt_in& in, cfg_trans& c) { c = in.cfg(); }
+
+// Continutul unui sc_fifo. sc_fifo nu are peek, asa ca elementele sunt scoase cu nb_read:
+// dupa save FIFO-ul e gol, deci rularea care a salvat snapshot-ul trebuie oprita (vezi Network::save_checkpoint).
+template <class T>
+void save_fifo(ckpt_out& out, sc_fifo<T>& f) {
+    std::vector<T> v;
+    T item;
+    while (f.num_available() > 0 && f.nb_read(item)) v.push_back(item);
+    out.put<uint32_t>((uint32_t)v.size());
+    for (size_t i = 0; i < v.size(); i++) ckpt_item(out, v[i]);
+}
+
+// Pune inapoi elementele salvate; se apeleaza la elaborare, cand FIFO-ul e gol
+template <class T>
+void load_fifo(ckpt_in& in, sc_fifo<T>& f) {
+    uint32_t n = in.get<uint32_t>();
+    for (uint32_t i = 0; i < n && in.ok(); i++) {
+        T item;
+        ckpt_item(in, item);
+        if (!f.nb_write(item)) in.fail(std::string("checkpoint does not fit in FIFO ") + f.name());
+    }
+}
+
+#endif
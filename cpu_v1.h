@@ -2,7 +2,13 @@
 #define CPU_H
 
 #include <systemc.h>
+#include <vector>
+#include <memory>
+#include <climits>
 #include "utils.h"
+#include "log.h"
+#include "checkpoint.h"
+#include "trace.h"
 
 SC_MODULE(CPU) {
     sc_fifo_out<packet> out_port; // Ieșire: Trimite Cereri (REQ_WRITE / REQ_READ)
@@ -13,16 +19,97 @@ SC_MODULE(CPU) {
     int test_addr;   // Adresa de memorie pe care o va testa
     int test_data;   // Datele pe care le va scrie
 
+    // Modul cu mai multe tranzactii in zbor (0 = testul original: un WRITE si un READ, blocant)
+    int num_transactions; // cate tranzactii trimitem in total
+    int window;           // cate cereri pot fi in zbor simultan (cate tag-uri avem)
+    int burst_len;        // cuvinte per tranzactie (> 1 = pachete cu mai multe flit-uri, wormhole)
+
+    // Redare dintr-un trace (set_trace): cererile vin din fisier in locul tiparului WRITE / READ
+    bool trace_closed_loop;      // true = fiecare cerere pleaca imediat ce are tag liber; false = la ciclul din trace
+    sc_time trace_cycle;         // durata unui ciclu din trace (implicit 10 ns, ca la routere)
+    uint64_t trace_last_cycle;   // ciclul ultimei cereri din trace (cat dureaza redarea cu timpi)
+    unsigned long trace_late;    // cereri plecate dupa ciclul lor (fereastra plina / retea blocata)
+    sc_time trace_slip;          // suma intarzierilor lor
+
+    // Rezultatele modului cu fereastra
+    int completed;        // raspunsuri primite si potrivite cu cererea lor
+    int errors;           // tag necunoscut, tip gresit de raspuns sau date gresite
+    bool stream_done;
+    sc_time stream_start, stream_end;
+    sc_time total_latency; // suma (raspuns - cerere) pe toate tranzactiile
+
+    // Progresul, tinut in membri ca sa poata fi salvat intr-un checkpoint
+    bool started;    // a trecut pauza initiala de 20 ns
+    bool basic_done; // testul original (WRITE + READ) s-a terminat
+    int issued;      // cate tranzactii au plecat complet
+    int issue_tag;   // tag-ul tranzactiei care se trimite acum (-1 = niciuna)
+    int issue_flit;  // urmatorul flit de trimis din tranzactia curenta
+    int rx_tag;      // tag-ul raspunsului in burst care se primeste acum
+    int rx_flit;     // cate flit-uri din el am primit (0 = asteptam un raspuns nou)
+
+    sc_time resume_at; // > 0: starea vine dintr-un checkpoint salvat la momentul asta
+
+    // Cere num tranzactii cu cel mult outstanding cereri in zbor, fiecare de burst cuvinte (se apeleaza inainte de sc_start)
+    void set_window(int num, int outstanding, int burst = 1) {
+        num_transactions = num;
+        window = (outstanding < 1) ? 1 : outstanding;
+        burst_len = (burst < 1) ? 1 : burst;
+    }
+
+    // Reda cererile din trace-ul binar path (trace.h) in locul tiparului fix, cu cel mult outstanding in zbor.
+    // closed_loop = false: fiecare cerere pleaca la ciclul ei din trace (sau cand se elibereaza un tag, daca e mai tarziu);
+    // closed_loop = true: timpii sunt ignorati, cererile pleaca cat de repede permite fereastra.
+    // Fisierul nu e incarcat in memorie, ci parcurs secvential cu TraceReader. Se apeleaza inainte de sc_start.
+    bool set_trace(const std::string& path, bool closed_loop, int outstanding) {
+        trace.reset(new TraceReader());
+        if (!trace->open(path) || trace->size() == 0) {
+            NOC_LOG(LOG_ERROR, "[CPU " << my_id << "] ERROR: " << (trace->error.empty() ? path + " is empty" : trace->error) << endl);
+            trace.reset();
+            return false;
+        }
+        uint64_t n = trace->size();
+        if (n > INT_MAX) {
+            NOC_LOG(LOG_INFO, "[CPU " << my_id << "] WARNING: replaying only the first " << INT_MAX << " of " << n << " requests" << endl);
+            n = INT_MAX;
+        }
+        trace_record last;
+        trace->seek(n - 1);
+        trace->next(last);
+        trace->seek(0);
+        trace_last_cycle = last.cycle;
+
+        set_window((int)n, outstanding, 1);
+        trace_closed_loop = closed_loop;
+        NOC_LOG(LOG_INFO, "[CPU " << my_id << "] Replaying " << path << ": " << n << " requests over " << trace_last_cycle << " cycles, "
+             << (closed_loop ? "closed loop" : "timed") << ", window " << window << endl);
+        return true;
+    }
 
     void behavior() {
-        wait(20, SC_NS); // astept ca sa se faca configuratiile in reteaua
+        if (resume_at > SC_ZERO_TIME) {
+            wait(resume_at);
+            if (started) {
+                if (num_transactions > 0) issue(); // testul original e deja gata (vezi save_state)
+                return;
+            }
+            if (sc_time_stamp() < sc_time(20, SC_NS)) wait(sc_time(20, SC_NS) - sc_time_stamp());
+        } else {
+            wait(20, SC_NS); // astept ca sa se faca configuratiile in reteaua
+        }
+        started = true;
+
+        if (num_transactions > 0) {
+            stream();
+            return;
+        }
 
         // --- Write ---
-        cout << "@" << sc_time_stamp() << " [CPU " << my_id << "] INIT WRITE -> MEM " << target_id 
-             << " | Adr:" << test_addr << " Val:" << test_data << endl;
+        NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CPU " << my_id << "] INIT WRITE -> MEM " << target_id 
+             << " | Adr:" << test_addr << " Val:" << test_data << endl);
 
         // pachetul de cerere
         packet p_req_wr(packet::REQ_WRITE, my_id, target_id, test_addr, test_data);
+        p_req_wr.inject_time = sc_time_stamp();
         out_port.write(p_req_wr);
 
         // blochez CPU si astept ACK de la MEM
@@ -30,9 +117,9 @@ SC_MODULE(CPU) {
         in_port.read(p_rsp); // Blocant
 
         if (p_rsp.type == packet::RSP_ACK) {
-            cout << "@" << sc_time_stamp() << " [CPU " << my_id << "] DONE WRITE (ACK Received)" << endl;
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CPU " << my_id << "] DONE WRITE (ACK Received)" << endl);
         } else {
-            cout << "@" << sc_time_stamp() << " [CPU " << my_id << "] ERROR: Expected ACK, got " << p_rsp << endl;
+            NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CPU " << my_id << "] ERROR: Expected ACK, got " << p_rsp << endl);
         }
 
         // facem pauza intre tranzactii
@@ -41,38 +128,277 @@ SC_MODULE(CPU) {
         // --- Read ---
         // Verificam daca datele au fost scrise corect
         
-        cout << "@" << sc_time_stamp() << " [CPU " << my_id << "] INIT READ  -> MEM " << target_id 
-             << " | Adr:" << test_addr << endl;
+        NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CPU " << my_id << "] INIT READ  -> MEM " << target_id 
+             << " | Adr:" << test_addr << endl);
 
         // La citire, datele trimise sunt 0 (irelevante), contează doar adresa
         packet p_req_rd(packet::REQ_READ, my_id, target_id, test_addr, 0);
+        p_req_rd.inject_time = sc_time_stamp();
         out_port.write(p_req_rd);
 
         // Așteptăm datele înapoi
         in_port.read(p_rsp); // Blocant: Așteaptă DATA
 
         if (p_rsp.type == packet::RSP_DATA) {
-            cout << "@" << sc_time_stamp() << " [CPU " << my_id << "] DONE READ (Data Received): " 
-                 << p_rsp.data << endl;
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CPU " << my_id << "] DONE READ (Data Received): " 
+                 << p_rsp.data << endl);
                  
             // Verificarea datei
             if (p_rsp.data == test_data) {
-                cout << "      ---> SUCCESS: Read value matches written value!" << endl;
+                NOC_LOG(LOG_INFO, "      ---> SUCCESS: Read value matches written value!" << endl);
+            } else {
+                NOC_LOG(LOG_ERROR, "      ---> FAILURE: Data Mismatch!" << endl);
+            }
+        } else {
+            NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CPU " << my_id << "] ERROR: Expected DATA, got " << p_rsp << endl);
+        }
+        basic_done = true;
+    }
+
+    // Trimite cereri cat timp avem tag-uri libere; raspunsurile sunt culese de collect().
+    // Tranzactia k: k par = WRITE la test_addr + (k/2) * burst_len, k impar = READ de la aceeasi adresa.
+    // Un WRITE in burst e un pachet de burst_len flit-uri; un READ in burst e un singur flit cu len = burst_len.
+    // READ-ul poate pleca inainte sa vina ACK-ul WRITE-ului: cu rutare determinista catre un singur MEM
+    // cele doua cereri merg pe acelasi drum (FIFO), deci MEM le vede tot in ordine.
+    void stream() {
+        slots.assign(window, TagSlot());
+        free_tags.clear();
+        for (int t = window - 1; t >= 0; t--) free_tags.push_back(t);
+
+        NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CPU " << my_id << "] STREAM " << num_transactions
+             << " transactions -> MEM " << target_id << " | window " << window << endl);
+
+        stream_start = sc_time_stamp();
+        stream_go.notify(SC_ZERO_TIME);
+        issue();
+    }
+
+    // Bucla de trimitere a cererilor; continua de la issued / issue_tag / issue_flit (reluare dintr-un checkpoint)
+    // Cu trace: tranzactia k e inregistrarea k din fisier.
+    void issue() {
+        if (trace) trace->seek(issued + (issue_tag >= 0 ? 1 : 0));
+
+        while (issued < num_transactions) {
+            if (issue_tag < 0) {
+                trace_record rec;
+                sc_time due = SC_ZERO_TIME;
+                if (trace) {
+                    if (!trace->next(rec)) {
+                        NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CPU " << my_id << "] ERROR: trace ended after " << issued << " requests" << endl);
+                        num_transactions = issued;
+                        break;
+                    }
+                    due = stream_start + trace_cycle * (double)rec.cycle;
+                    if (!trace_closed_loop && due > sc_time_stamp()) wait(due - sc_time_stamp());
+                }
+
+                while (free_tags.empty()) wait(slot_freed); // fereastra e plina
+
+                int tag = free_tags.back();
+                free_tags.pop_back();
+
+                int k = issued;
+                int addr = test_addr + (k / 2) * burst_len;
+                packet req;
+                if (trace) {
+                    req = (rec.type == TRACE_WRITE)
+                        ? packet(packet::REQ_WRITE, my_id, rec.dst_id, rec.address, rec.data, tag)
+                        : packet(packet::REQ_READ, my_id, rec.dst_id, rec.address, 0, tag);
+                    if (!trace_closed_loop && sc_time_stamp() > due) {
+                        trace_late++;
+                        trace_slip += sc_time_stamp() - due;
+                    }
+                } else {
+                    req = (k % 2 == 0)
+                        ? packet(packet::REQ_WRITE, my_id, target_id, addr, expected_data(addr), tag)
+                        : packet(packet::REQ_READ, my_id, target_id, addr, 0, tag);
+                }
+                req.len = burst_len;
+                req.inject_time = sc_time_stamp(); // varsta pachetului pentru arbitrarea OLDEST_FIRST
+
+                slots[tag].busy = true;
+                slots[tag].req = req;
+                slots[tag].issue_time = sc_time_stamp();
+                issue_tag = tag;
+                issue_flit = 0;
+
+                NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CPU " << my_id << "] ISSUE tag " << tag << ": " << req << endl);
+            }
+
+            packet req = slots[issue_tag].req;
+            if (req.type == packet::REQ_WRITE && burst_len > 1) {
+                for (; issue_flit < burst_len; issue_flit++) {
+                    out_port.write(packet::make_flit(req, issue_flit, burst_len, expected_data(req.address + issue_flit)));
+                }
+            } else {
+                out_port.write(req);
+            }
+            issue_tag = -1;
+            issue_flit = 0;
+            issued++;
+        }
+    }
+
+    // Culege raspunsurile (pot veni in orice ordine) si le potriveste cu cererea dupa tag
+    void collect() {
+        if (resume_at > SC_ZERO_TIME && started && num_transactions > 0) {
+            wait(resume_at);
+            if (stream_done) return;
+        } else {
+            wait(stream_go);
+        }
+
+        while (completed < num_transactions) {
+            packet rsp = in_port.read();
+
+            if (rx_flit == 0) {
+                if (rsp.tag < 0 || rsp.tag >= window || !slots[rsp.tag].busy) {
+                    NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CPU " << my_id << "] ERROR: Unknown tag in " << rsp << endl);
+                    errors++;
+                    continue;
+                }
+                rx_tag = rsp.tag;
+            }
+
+            TagSlot& slot = slots[rx_tag];
+            if (slot.req.type == packet::REQ_WRITE) {
+                if (rsp.type != packet::RSP_ACK) {
+                    NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CPU " << my_id << "] ERROR: Expected ACK, got " << rsp << endl);
+                    errors++;
+                }
             } else {
-                cout << "      ---> FAILURE: Data Mismatch!" << endl;
+                // Burst: restul flit-urilor vin imediat dupa cap (iesirea locala e alocata pachetului pana la TAIL)
+                // Din trace nu stim ce contine memoria, verificam doar tipul raspunsului
+                int expected = expected_data(slot.req.address + rx_flit);
+                if (rsp.type != packet::RSP_DATA || (!trace && rsp.data != expected)) {
+                    NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CPU " << my_id << "] ERROR: Expected DATA " << expected << ", got " << rsp << endl);
+                    errors++;
+                }
+                if (!rsp.is_tail()) {
+                    rx_flit++;
+                    continue;
+                }
             }
+            rx_flit = 0;
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CPU " << my_id << "] DONE tag " << rsp.tag << ": " << rsp << endl);
+
+            total_latency += sc_time_stamp() - slot.issue_time;
+            slot.busy = false;
+            free_tags.push_back(rx_tag);
+            slot_freed.notify();
+            completed++;
+        }
+
+        stream_end = sc_time_stamp();
+        stream_done = true;
+
+        double ns = (stream_end - stream_start).to_seconds() * 1e9;
+        NOC_LOG(LOG_INFO, "@" << sc_time_stamp() << " [CPU " << my_id << "] STREAM DONE: " << completed << " transactions in "
+             << ns << " ns (" << completed / ns * 1e3 << " trans/us, " << completed * burst_len / ns * 1e3 << " words/us), window " << window
+             << ", burst " << burst_len
+             << ", avg latency " << total_latency.to_seconds() * 1e9 / completed << " ns" << endl);
+        if (trace && !trace_closed_loop) {
+            NOC_LOG(LOG_INFO, "@" << sc_time_stamp() << " [CPU " << my_id << "] TRACE: " << trace_late << " of " << completed
+                 << " requests issued late, avg slip " << (trace_late ? trace_slip.to_seconds() * 1e9 / trace_late : 0.0) << " ns" << endl);
+        }
+        if (errors == 0) {
+            NOC_LOG(LOG_INFO, "      ---> SUCCESS: All responses matched their requests!" << endl);
         } else {
-            cout << "@" << sc_time_stamp() << " [CPU " << my_id << "] ERROR: Expected DATA, got " << p_rsp << endl;
+            NOC_LOG(LOG_ERROR, "      ---> FAILURE: " << errors << " bad responses!" << endl);
         }
     }
 
+    // Checkpoint: configuratia testului si progresul (tranzactiile in zbor, pozitia in burst-uri)
+    void save_state(ckpt_out& out) const {
+        if (started && num_transactions == 0 && !basic_done) {
+            out.fail(std::string(name()) + ": the basic WRITE/READ test can only be saved before it starts or after it ends");
+        }
+        out.section("CPU ");
+        int32_t v[12] = { started, basic_done, num_transactions, window, burst_len, completed,
+                          errors, stream_done, issued, issue_tag, issue_flit, rx_tag };
+        out.put(v);
+        out.put<int32_t>(rx_flit);
+        out.time(stream_start);
+        out.time(stream_end);
+        out.time(total_latency);
+        out.put<uint32_t>((uint32_t)slots.size());
+        for (size_t i = 0; i < slots.size(); i++) {
+            out.put<int32_t>(slots[i].busy);
+            out.pkt(slots[i].req);
+            out.time(slots[i].issue_time);
+        }
+        out.items(free_tags);
+        // Pozitia in trace e issued (fisierul insusi nu intra in checkpoint, se redeschide din NOC_TRACE)
+        out.put<int32_t>(trace ? (trace_closed_loop ? 2 : 1) : 0);
+        out.put<uint64_t>(trace_late);
+        out.time(trace_slip);
+    }
+
+    void load_state(ckpt_in& in, const sc_time& at) {
+        if (!in.section("CPU ")) return;
+        int32_t v[12];
+        in.raw(v, sizeof(v));
+        started = v[0] != 0;
+        basic_done = v[1] != 0;
+        num_transactions = v[2];
+        window = v[3];
+        burst_len = v[4];
+        completed = v[5];
+        errors = v[6];
+        stream_done = v[7] != 0;
+        issued = v[8];
+        issue_tag = v[9];
+        issue_flit = v[10];
+        rx_tag = v[11];
+        rx_flit = in.get<int32_t>();
+        stream_start = in.time();
+        stream_end = in.time();
+        total_latency = in.time();
+        slots.assign(in.get<uint32_t>(), TagSlot());
+        for (size_t i = 0; i < slots.size() && in.ok(); i++) {
+            slots[i].busy = in.get<int32_t>() != 0;
+            slots[i].req = in.pkt();
+            slots[i].issue_time = in.time();
+        }
+        in.items(free_tags);
+        int32_t trace_mode = in.get<int32_t>();
+        if (in.ok() && trace_mode != (trace ? (trace_closed_loop ? 2 : 1) : 0)) {
+            in.fail(std::string(name()) + ": checkpoint was saved with a different trace setting");
+        }
+        trace_late = in.get<uint64_t>();
+        trace_slip = in.time();
+        resume_at = at;
+    }
+
     SC_HAS_PROCESS(CPU);
 
     CPU(sc_module_name name, int id, int target, int addr, int data) 
-        : sc_module(name), my_id(id), target_id(target), test_addr(addr), test_data(data) 
+        : sc_module(name), my_id(id), target_id(target), test_addr(addr), test_data(data),
+          num_transactions(0), window(1), burst_len(1),
+          trace_closed_loop(false), trace_cycle(10, SC_NS), trace_last_cycle(0), trace_late(0),
+          completed(0), errors(0), stream_done(false),
+          started(false), basic_done(false), issued(0), issue_tag(-1), issue_flit(0), rx_tag(-1), rx_flit(0)
     {
         SC_THREAD(behavior);
+        SC_THREAD(collect); // doarme pana cand behavior() porneste modul cu fereastra
     }
+
+private:
+    // Valoarea pe care o scriem (si apoi o asteptam la citire) la adresa addr
+    int expected_data(int addr) const { return test_data + (addr - test_addr); }
+
+    // O intrare per tag: cererea aflata in zbor cu acel tag
+    struct TagSlot {
+        bool busy;
+        packet req;
+        sc_time issue_time;
+        TagSlot() : busy(false) {}
+    };
+    std::vector<TagSlot> slots;
+    std::unique_ptr<TraceReader> trace; // NULL = tiparul fix (set_trace)
+    std::vector<int> free_tags;
+    sc_event stream_go;  // behavior() a pornit modul cu fereastra
+    sc_event slot_freed; // s-a eliberat un tag
 };
 
 #endif
\ No newline at end of file
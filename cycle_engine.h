@@ -0,0 +1,389 @@
+// cycle_engine.h
+#ifndef CYCLE_ENGINE_H
+#define CYCLE_ENGINE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include "noc_types.h"
+#include "route_table.h"
+#include "log.h"
+
+// Motor de simulare pe cicluri, fara kernel SystemC, pentru sweep-uri mari.
+// Ruleaza aceeasi logica de router ca Router in modul SWITCH_SINGLE (un pachet pe ciclu): config inainte
+// de arbitrare, PRIORITY / ROUND_ROBIN / WEIGHTED_RR, tabela de rutare sau XY, porturi dezactivate, drop-uri, blocare
+// pe o iesire plina. Nu are wormhole (pachetele sunt de un singur flit), modul crossbar, OLDEST_FIRST si nici rutarea
+// adaptiva: configure() refuza comenzile care le cer, ca un sweep sa nu raporteze o politica pe care n-a simulat-o.
+//
+// Starea e tinuta ca structure-of-arrays: fiecare camp al routerelor e un vector plat indexat cu
+// r (sau r * NUM_PORTS + port), iar legaturile sunt ring buffer-e prealocate intr-un singur vector.
+// Un ciclu = o trecere prin toate routerele + commit-ul legaturilor, fara evenimente, procese sau sc_time.
+//
+// Semantica de timp e cea a lui sc_fifo: ce scrie un router in ciclul c devine vizibil in ciclul c + 1
+// (commit la finalul ciclului, ca faza de update), iar locurile eliberate de un router devin libere tot de
+// la ciclul urmator. Perifericele (inject / eject) lucreaza intre cicluri si vad imediat ce au scris
+// routerele, exact ca un CPU / MEM care se trezeste pe data_written_event() la acelasi timestamp.
+//
+// run_parallel() imparte routerele in partitii contigue, cate una pe thread. Fiecare legatura are un singur
+// producator si un singur consumator (tail e scris doar de producator, head doar de consumator), deci ring-ul
+// e o coada SPSC; commit-ul unei legaturi il face thread-ul consumatorului. Thread-urile se sincronizeaza
+// cu o bariera intre faza de rutare si faza de commit + periferice, deci nimeni nu citeste in ciclul c ce
+// a scris alt thread in ciclul c. Rezultatul nu depinde de numarul de thread-uri.
+
+// Pachetul motorului: aceleasi campuri si coduri de tip ca packet (utils.h), fara sc_time
+struct cpacket {
+    enum Type { REQ_WRITE = 0, REQ_READ = 1, RSP_ACK = 2, RSP_DATA = 3 };
+
+    int type;
+    int src_id;
+    int dst_id;
+    int address;
+    int data;
+    int tag;
+    uint64_t inject_cycle; // pentru latenta (echivalentul lui packet::inject_time)
+
+    cpacket() : type(REQ_WRITE), src_id(0), dst_id(0), address(0), data(0), tag(0), inject_cycle(0) {}
+
+    cpacket(int t, int s, int d, int addr, int val, int tg = 0)
+        : type(t), src_id(s), dst_id(d), address(addr), data(val), tag(tg), inject_cycle(0) {}
+
+    // Acelasi format ca operator<< din packet, ca log-urile celor doua motoare sa poata fi comparate
+    friend std::ostream& operator<<(std::ostream& os, const cpacket& p) {
+        static const char* names[] = { "WRITE", "READ ", "ACK  ", "DATA " };
+        os << "[" << ((p.type >= 0 && p.type <= 3) ? names[p.type] : "???? ")
+           << " Src:" << p.src_id << " -> Dst:" << p.dst_id << " Addr:" << p.address << " Data:" << p.data << "]";
+        return os;
+    }
+};
+
+// Bariera cu sens inversat pentru thread-urile din run_parallel(). Asteptarea e activa (un ciclu de router
+// dureaza cateva microsecunde), dar cedeaza procesorul daca dureaza, ca sa nu blocheze pe masini cu putine core-uri.
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int n) : count(n), waiting(0), sense(false) {}
+
+    void wait() {
+        bool my_sense = !sense.load(std::memory_order_relaxed);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) == count - 1) {
+            waiting.store(0, std::memory_order_relaxed);
+            sense.store(my_sense, std::memory_order_release);
+            return;
+        }
+        for (int spins = 0; sense.load(std::memory_order_acquire) != my_sense; spins++) {
+            if (spins > 64) std::this_thread::yield();
+        }
+    }
+
+private:
+    const int count;
+    std::atomic<int> waiting;
+    std::atomic<bool> sense;
+};
+
+// Un timp in ps afisat ca sc_time (cea mai mare unitate in care valoarea e intreaga: "30 ns", "2 us")
+inline std::string format_time_ps(uint64_t ps) {
+    static const char* units[] = { "ps", "ns", "us", "ms", "s" };
+    if (ps == 0) return "0 s";
+    int u = 0;
+    while (u < 4 && ps % 1000 == 0) {
+        ps /= 1000;
+        u++;
+    }
+    return std::to_string(ps) + " " + units[u];
+}
+
+class CycleEngine {
+public:
+    static const int NO_LINK = -1;
+
+    // --- Routere (indexate cu r, sau cu r * NUM_PORTS + port) ---
+    int num_routers;
+    std::vector<RouteTable> routing_table;
+    std::vector<uint8_t> port_enabled;    // [r * NUM_PORTS + p]
+    std::vector<int> in_link;             // legatura din care citeste portul p (NO_LINK = nelegat)
+    std::vector<int> out_link;            // legatura in care scrie portul p
+    std::vector<uint8_t> arbitration_policy;
+    std::vector<uint8_t> routing_mode;
+    std::vector<int8_t> last_served_port;
+    std::vector<int> arb_weight;          // [r * NUM_PORTS + p], WEIGHTED_RR (SET_ARB_WEIGHT)
+    std::vector<int> arb_left;            // WEIGHTED_RR: grant-urile ramase pentru last_served_port in runda curenta
+    std::vector<int16_t> my_x, my_y;
+
+    // Blocare pe o iesire plina (ca out_ports[].write() blocant): routerul nu mai face nimic pana scrie pachetul
+    std::vector<uint8_t> stalled;
+    std::vector<int8_t> stalled_in, stalled_out;
+    std::vector<cpacket> stalled_pkt;
+    std::vector<uint64_t> stalled_since; // ciclul arbitrarii (pentru log si blocked_cycles)
+
+    std::vector<std::vector<cfg_trans> > pending_cfg; // aplicate la inceputul urmatorului ciclu al routerului
+
+    // Statistici (aceleasi ca RouterStats, in cicluri)
+    std::vector<uint64_t> forwarded; // [(r * NUM_PORTS + in) * NUM_PORTS + out]
+    std::vector<uint64_t> drop_no_route, drop_disabled, blocked_cycles;
+
+    // --- Legaturi: ring buffer-e de link_depth pachete, toate in slots ---
+    int link_depth;
+    std::vector<cpacket> slots;      // legatura l foloseste slots[l * ring_size .. (l + 1) * ring_size)
+    std::vector<uint32_t> head;      // urmatorul pachet de citit
+    std::vector<uint32_t> tail;      // urmatorul loc de scris
+    std::vector<uint32_t> vis_tail;  // pana unde vad cititorii (tail-ul de la ultimul commit)
+    std::vector<uint32_t> free_head; // pana unde sunt libere locurile pentru scriitori (head-ul de la ultimul commit)
+
+    uint64_t cycle;    // ultimul ciclu simulat (0 = inainte de primul)
+    uint64_t cycle_ps; // durata unui ciclu, doar pentru afisare (10 ns ca Router::cycle_time)
+
+    std::ostream* trace; // log-ul per hop (acelasi format ca NOC_LOG=trace), NULL = fara log
+
+    CycleEngine(int routers, int depth = 16, uint64_t cycle_length_ps = 10000)
+        : num_routers(routers), routing_table(routers), port_enabled(routers * NUM_PORTS, 1),
+          in_link(routers * NUM_PORTS, NO_LINK), out_link(routers * NUM_PORTS, NO_LINK),
+          arbitration_policy(routers, PRIORITY), routing_mode(routers, ROUTE_TABLE), last_served_port(routers, NUM_PORTS - 1),
+          arb_weight(routers * NUM_PORTS, 1), arb_left(routers, 0), my_x(routers, 0), my_y(routers, 0),
+          stalled(routers, 0), stalled_in(routers, 0), stalled_out(routers, 0), stalled_pkt(routers), stalled_since(routers, 0),
+          pending_cfg(routers),
+          forwarded(routers * NUM_PORTS * NUM_PORTS, 0), drop_no_route(routers, 0), drop_disabled(routers, 0), blocked_cycles(routers, 0),
+          link_depth(depth), cycle(0), cycle_ps(cycle_length_ps), trace(NULL), ring_bits(0), num_partitions(0)
+    {
+        while ((1 << ring_bits) < depth) ring_bits++;
+    }
+
+    // O legatura noua (un sc_fifo<packet>(link_depth)), intoarce id-ul ei
+    int add_link() {
+        int id = (int)head.size();
+        head.push_back(0);
+        tail.push_back(0);
+        consumer.push_back(-1);
+        num_partitions = 0; // partitiile se recalculeaza la urmatorul run_parallel()
+        vis_tail.push_back(0);
+        free_head.push_back(0);
+        slots.resize((size_t)(id + 1) << ring_bits);
+        return id;
+    }
+
+    // Portul port al routerului r citeste din in_l si scrie in out_l (NO_LINK = nelegat)
+    // Legaturile citite de periferice (out_l fara alt router consumator) apartin partitiei routerului r.
+    void connect(int r, int port, int in_l, int out_l) {
+        in_link[r * NUM_PORTS + port] = in_l;
+        out_link[r * NUM_PORTS + port] = out_l;
+        if (in_l != NO_LINK) consumer[in_l] = r;
+        if (out_l != NO_LINK && consumer[out_l] < 0) consumer[out_l] = r;
+        num_partitions = 0;
+    }
+
+    // Echivalentul unui cfg_port.write(): se aplica la inceputul urmatorului ciclu al routerului.
+    // SET_SWITCH / SET_Q_LEN nu au efect (motorul are un singur mod si adancime fixa).
+    // Intoarce false (si nu pune comanda in coada) pentru valori invalide sau moduri pe care motorul nu le are.
+    bool configure(int r, const cfg_trans& c) {
+        const char* why = NULL;
+        if ((c.type == cfg_trans::ENABLE_PORT || c.type == cfg_trans::SET_ARB_WEIGHT) && (c.target < 0 || c.target >= NUM_PORTS)) {
+            why = "invalid port";
+        } else if (c.type == cfg_trans::SET_ARBITER && c.value != PRIORITY && c.value != ROUND_ROBIN && c.value != WEIGHTED_RR) {
+            why = "unsupported arbiter";
+        } else if (c.type == cfg_trans::SET_ROUTING && c.value != ROUTE_TABLE && c.value != ROUTE_XY) {
+            why = "unsupported routing mode";
+        }
+        if (why != NULL) {
+            NOC_LOG(LOG_ERROR, "[ENGINE] ERROR: router " << r << ": " << why << " in " << c << std::endl);
+            return false;
+        }
+        pending_cfg[r].push_back(c);
+        return true;
+    }
+
+    // --- Interfata perifericelor (intre cicluri) ---
+
+    // Scrie un pachet pe legatura (vizibil routerului din ciclul urmator). false = legatura e plina.
+    bool inject(int l, const cpacket& p) {
+        if (tail[l] - free_head[l] >= (uint32_t)link_depth) return false;
+        slot(l, tail[l]) = p;
+        tail[l]++;
+        vis_tail[l] = tail[l];
+        return true;
+    }
+
+    // Citeste un pachet scris de router (inclusiv in ciclul curent). false = nu e nimic.
+    bool eject(int l, cpacket& p) {
+        if (head[l] == vis_tail[l]) return false;
+        p = slot(l, head[l]);
+        head[l]++;
+        free_head[l] = head[l];
+        return true;
+    }
+
+    int occupancy(int l) const { return (int)(tail[l] - head[l]); }
+
+    // Un ciclu: toate routerele, apoi commit pe toate legaturile
+    void run_cycle() {
+        cycle++;
+        for (int r = 0; r < num_routers; r++) step(r, cycle);
+
+        // Commit (faza de update a sc_fifo): o bucla plata peste vectori, fara ramificatii
+        size_t n = head.size();
+        for (size_t l = 0; l < n; l++) {
+            vis_tail[l] = tail[l];
+            free_head[l] = head[l];
+        }
+    }
+
+    // Ruleaza pana la ciclul until cu threads thread-uri. Dupa commit-ul fiecarui ciclu, fiecare thread apeleaza
+    // periph(first, last, c) pentru routerele lui [first, last): acolo se fac inject / eject pe legaturile locale
+    // ale acestor routere (si doar pe ele). Cu trace activ rulam pe un singur thread, ca log-ul sa fie in ordine.
+    template <class F>
+    void run_parallel(uint64_t until, int threads, F periph) {
+        if (threads < 1 || trace) threads = 1;
+        if (threads > num_routers) threads = num_routers;
+        partition(threads);
+
+        SpinBarrier barrier(threads);
+        uint64_t first_cycle = cycle + 1;
+        auto worker = [&](int t) {
+            int r0 = part_first[t], r1 = part_first[t + 1];
+            const std::vector<int>& links = part_links[t];
+            for (uint64_t c = first_cycle; c <= until; c++) {
+                for (int r = r0; r < r1; r++) step(r, c);
+                barrier.wait();
+                for (size_t i = 0; i < links.size(); i++) {
+                    int l = links[i];
+                    vis_tail[l] = tail[l];
+                    free_head[l] = head[l];
+                }
+                periph(r0, r1, c);
+                barrier.wait();
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; t++) pool.push_back(std::thread(worker, t));
+        worker(0);
+        for (size_t i = 0; i < pool.size(); i++) pool[i].join();
+        if (until > cycle) cycle = until;
+    }
+
+    uint64_t total_routed() const {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < forwarded.size(); i++) sum += forwarded[i];
+        return sum;
+    }
+
+private:
+    int ring_bits; // fiecare legatura are 2^ring_bits locuri in slots (>= link_depth)
+
+    std::vector<int> consumer;                 // consumer[l] = routerul a carui partitie face commit-ul legaturii l
+    int num_partitions;
+    std::vector<int> part_first;               // partitia t are routerele [part_first[t], part_first[t + 1])
+    std::vector<std::vector<int> > part_links; // legaturile la care partitia t face commit
+
+    void partition(int threads) {
+        if (threads == num_partitions) return;
+        num_partitions = threads;
+        part_first.assign(threads + 1, 0);
+        for (int t = 0; t <= threads; t++) part_first[t] = (int)((long)num_routers * t / threads);
+        part_links.assign(threads, std::vector<int>());
+        for (size_t l = 0; l < consumer.size(); l++) {
+            int r = (consumer[l] < 0) ? 0 : consumer[l];
+            int t = 0;
+            while (r >= part_first[t + 1]) t++;
+            part_links[t].push_back((int)l);
+        }
+    }
+
+    cpacket& slot(int l, uint32_t idx) {
+        return slots[((size_t)l << ring_bits) + (idx & ((1u << ring_bits) - 1))];
+    }
+
+    bool can_write(int l) const { return tail[l] - free_head[l] < (uint32_t)link_depth; }
+
+    // Un ciclu al routerului r: aceeasi ordine ca Router::step() (config, arbitrare, rutare a cel mult unui pachet)
+    void step(int r, uint64_t c) {
+        const int base = r * NUM_PORTS;
+
+        if (!pending_cfg[r].empty()) {
+            for (size_t i = 0; i < pending_cfg[r].size(); i++) apply_config(r, pending_cfg[r][i]);
+            pending_cfg[r].clear();
+        }
+
+        if (stalled[r]) {
+            int ol = out_link[base + stalled_out[r]];
+            if (!can_write(ol)) {
+                blocked_cycles[r]++;
+                return;
+            }
+            push(ol, stalled_pkt[r]);
+            stalled[r] = 0;
+            blocked_cycles[r]++;
+            if (trace) log_hop(stalled_in[r], stalled_pkt[r], stalled_out[r], stalled_since[r]);
+            return;
+        }
+
+        int start = arb_start(arbitration_policy[r], last_served_port[r], arb_left[r]);
+        for (int i = 0; i < NUM_PORTS; i++) {
+            int p = start + i;
+            if (p >= NUM_PORTS) p -= NUM_PORTS;
+            if (!port_enabled[base + p]) continue;
+            int il = in_link[base + p];
+            if (il == NO_LINK || head[il] == vis_tail[il]) continue;
+
+            cpacket pkt = slot(il, head[il]);
+            head[il]++;
+            arb_left[r] = arb_left_after(arbitration_policy[r], p, last_served_port[r], arb_left[r], &arb_weight[base]);
+            last_served_port[r] = (int8_t)p;
+
+            int out = (routing_mode[r] == ROUTE_XY) ? xy_route_port(my_x[r], my_y[r], pkt.dst_id)
+                                                    : routing_table[r].lookup(pkt.dst_id);
+            if (out == RouteTable::NO_ROUTE) {
+                drop_no_route[r]++;
+                if (trace) log_hop(p, pkt, out, c);
+                return;
+            }
+            int ol = out_link[base + out];
+            if (!port_enabled[base + out] || ol == NO_LINK) {
+                drop_disabled[r]++;
+                if (trace) log_hop(p, pkt, -2 - out, c);
+                return;
+            }
+            forwarded[(base + p) * NUM_PORTS + out]++;
+            if (can_write(ol)) {
+                push(ol, pkt);
+                if (trace) log_hop(p, pkt, out, c);
+            } else {
+                stalled[r] = 1;
+                stalled_in[r] = (int8_t)p;
+                stalled_out[r] = (int8_t)out;
+                stalled_pkt[r] = pkt;
+                stalled_since[r] = c;
+            }
+            return;
+        }
+    }
+
+    void push(int l, const cpacket& p) {
+        slot(l, tail[l]) = p;
+        tail[l]++;
+    }
+
+    // Aceleasi comenzi ca apply_router_config() din router.h, pentru ce a trecut de configure()
+    void apply_config(int r, const cfg_trans& c) {
+        switch (c.type) {
+            case cfg_trans::SET_ROUTE:       routing_table[r].set(c.target, c.value); break;
+            case cfg_trans::SET_ROUTE_RANGE: routing_table[r].set_range(c.target, c.aux, c.value); break;
+            case cfg_trans::LOAD_TABLE:      if (c.table) routing_table[r].load(*c.table, c.target); break;
+            case cfg_trans::ENABLE_PORT:     port_enabled[r * NUM_PORTS + c.target] = (c.value != 0); break;
+            case cfg_trans::SET_ROUTING:     routing_mode[r] = (uint8_t)c.value; break;
+            case cfg_trans::SET_ARBITER:     arbitration_policy[r] = (uint8_t)c.value; break;
+            case cfg_trans::SET_ARB_WEIGHT:  arb_weight[r * NUM_PORTS + c.target] = (c.value > 0) ? c.value : 1; break;
+        }
+    }
+
+    // Aceeasi linie ca Router::step() la NOC_LOG=trace. out >= 0: forward, NO_ROUTE: fara ruta, -2 - port: port dezactivat
+    void log_hop(int in, const cpacket& p, int out, uint64_t at) {
+        *trace << "@" << format_time_ps(at * cycle_ps) << " [ROUTER] Pkt in port " << PortNames[in] << ": " << p;
+        if (out >= 0) *trace << " -> Fwd to Port " << PortNames[out] << "\n";
+        else if (out == RouteTable::NO_ROUTE) *trace << " -> DROP: No route for Destination " << p.dst_id << "\n";
+        else *trace << " -> DROP: Port " << PortNames[-2 - out] << " disabled\n";
+    }
+};
+
+#endif
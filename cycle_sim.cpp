@@ -0,0 +1,388 @@
+// Motorul pe cicluri (cycle_engine.h) pe aceleasi scenarii ca modelul SystemC, plus un mesh pentru sweep-uri.
+// Nu are nevoie de SystemC:
+//   g++ -O2 -pthread -o cycle_sim cycle_sim.cpp
+//   ./cycle_sim L0 [check=<log>]       -> scenariul din L0_router.cpp
+//   ./cycle_sim L1 [check=<log>]       -> lantul de 8 routere din L1_network.cpp (CPU 20 -> MEM 200)
+//   ./cycle_sim mesh [rows=8] [cols=8] [rate=0.05] [cycles=6000] [seed=1] [threads=1]
+//                                      -> trafic uniform pe un mesh cu rutare XY (ca L2_traffic.cpp)
+//   ./cycle_sim scaling [rate=0.05] [cycles=6000] [threads=8]
+//                                      -> speedup vs numarul de thread-uri pe mesh-uri de 64, 256 si 1024 de routere
+// Cu check=<log> se compara evenimentele [ROUTER] (timp, port, pachet, decizie) cu log-ul modelului SystemC:
+//   NOC_LOG=trace ./l0_sim > l0.log && ./cycle_sim L0 check=l0.log
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include "cycle_engine.h"
+#include "mem_store.h"
+#include "log.h"
+
+using namespace std;
+
+// CPU-ul din testul original (cpu_v1.h fara fereastra): un WRITE, asteapta ACK, pauza 50 ns, un READ, asteapta DATA
+struct CycleCPU {
+    int id, target, addr, data;
+    int req_link, rsp_link;
+    enum { WAIT_START, WAIT_ACK, PAUSE, WAIT_DATA, DONE } state;
+    uint64_t wake;
+    bool success;
+
+    CycleCPU(int i, int t, int a, int d, int req, int rsp)
+        : id(i), target(t), addr(a), data(d), req_link(req), rsp_link(rsp), state(WAIT_START), wake(2), success(false) {}
+
+    void tick(CycleEngine& eng) {
+        cpacket p;
+        switch (state) {
+            case WAIT_START: // wait(20, SC_NS)
+                if (eng.cycle < wake) return;
+                eng.inject(req_link, cpacket(cpacket::REQ_WRITE, id, target, addr, data));
+                state = WAIT_ACK;
+                return;
+            case WAIT_ACK:
+                if (!eng.eject(rsp_link, p)) return;
+                if (p.type != cpacket::RSP_ACK) NOC_LOG(LOG_ERROR, "[CPU " << id << "] ERROR: Expected ACK, got " << p << endl);
+                wake = eng.cycle + 5; // wait(50, SC_NS)
+                state = PAUSE;
+                return;
+            case PAUSE:
+                if (eng.cycle < wake) return;
+                eng.inject(req_link, cpacket(cpacket::REQ_READ, id, target, addr, 0));
+                state = WAIT_DATA;
+                return;
+            case WAIT_DATA:
+                if (!eng.eject(rsp_link, p)) return;
+                success = (p.type == cpacket::RSP_DATA && p.data == data);
+                state = DONE;
+                return;
+            case DONE:
+                return;
+        }
+    }
+};
+
+// MEM din mem.h: citeste o cerere, raspunde dupa un ciclu (10 ns), apoi citeste urmatoarea
+struct CycleMEM {
+    int id;
+    int req_link, rsp_link;
+    PagedStore store;
+    bool busy;
+    cpacket rsp;
+    uint64_t ready;
+
+    CycleMEM(int i, int req, int rsp_l) : id(i), req_link(req), rsp_link(rsp_l), busy(false), ready(0) {}
+
+    void tick(CycleEngine& eng) {
+        if (busy) {
+            if (eng.cycle < ready || !eng.inject(rsp_link, rsp)) return;
+            busy = false;
+        }
+        cpacket req;
+        if (!eng.eject(req_link, req)) return;
+        if (req.type == cpacket::REQ_WRITE) {
+            store.write(req.address, req.data);
+            rsp = cpacket(cpacket::RSP_ACK, id, req.src_id, req.address, 0, req.tag);
+        } else {
+            rsp = cpacket(cpacket::RSP_DATA, id, req.src_id, req.address, store.read(req.address), req.tag);
+        }
+        busy = true;
+        ready = eng.cycle + 1;
+    }
+};
+
+// Un port inchis (close_port din L1 / mesh): doua legaturi pe care nu circula nimic
+static void close_port(CycleEngine& eng, int r, int port) {
+    eng.connect(r, port, eng.add_link(), eng.add_link());
+}
+
+// Scenariul din L0_router.cpp
+static void run_l0(CycleEngine& eng) {
+    int in[NUM_PORTS], out[NUM_PORTS];
+    for (int p = 0; p < NUM_PORTS; p++) {
+        in[p] = eng.add_link();
+        out[p] = eng.add_link();
+        eng.connect(0, p, in[p], out[p]);
+    }
+    eng.configure(0, cfg_trans(cfg_trans::SET_ROUTE, 10, 0));
+    eng.configure(0, cfg_trans(cfg_trans::SET_ROUTE, 20, 2));
+    eng.configure(0, cfg_trans(cfg_trans::SET_ROUTE, 35, 0));
+    eng.configure(0, cfg_trans(cfg_trans::SET_ROUTE, 120, 3));
+    eng.configure(0, cfg_trans(cfg_trans::ENABLE_PORT, V, 0));
+
+    while (eng.cycle < 2) eng.run_cycle(); // sc_start(20, SC_NS)
+
+    eng.inject(in[V], cpacket(cpacket::REQ_WRITE, 99, 10, 0, 100));
+    eng.inject(in[E], cpacket(cpacket::REQ_WRITE, 20, 34, 0, 100));
+    eng.inject(in[N], cpacket(cpacket::REQ_WRITE, 88, 20, 5, 500));
+    eng.inject(in[S], cpacket(cpacket::REQ_WRITE, 120, 35, 8, 40));
+    eng.inject(in[S], cpacket(cpacket::REQ_WRITE, 1, 120, 12, 43));
+
+    while (eng.cycle < 12) eng.run_cycle(); // sc_start(100, SC_NS)
+
+    for (int p = 0; p < V + 1; p++) {
+        cpacket pk;
+        if (eng.eject(out[p], pk)) cout << "Received on " << PortNames[p] << ": " << pk << endl;
+        else cout << PortNames[p] << " is empty." << endl;
+    }
+}
+
+// Lantul de 8 routere din L1_network.cpp
+static void run_l1(CycleEngine& eng) {
+    int fwd[7], bwd[7];
+    for (int i = 0; i < 7; i++) {
+        fwd[i] = eng.add_link();
+        bwd[i] = eng.add_link();
+    }
+    for (int i = 0; i < 8; i++) {
+        eng.connect(i, E, (i < 7) ? bwd[i] : CycleEngine::NO_LINK, (i < 7) ? fwd[i] : CycleEngine::NO_LINK);
+        eng.connect(i, V, (i > 0) ? fwd[i - 1] : CycleEngine::NO_LINK, (i > 0) ? bwd[i - 1] : CycleEngine::NO_LINK);
+        close_port(eng, i, L);
+        close_port(eng, i, N);
+        if (i != 0) close_port(eng, i, S);
+    }
+
+    // perifericele: (router, port) ca in Network
+    int cpu_req = eng.add_link(), cpu_rsp = eng.add_link();
+    eng.connect(0, V, cpu_req, cpu_rsp);
+    int m83_req = eng.add_link(), m83_rsp = eng.add_link();
+    eng.connect(0, S, m83_rsp, m83_req);
+    int m200_req = eng.add_link(), m200_rsp = eng.add_link();
+    eng.connect(7, E, m200_rsp, m200_req);
+
+    CycleCPU cpu(20, 200, 10, 83, cpu_req, cpu_rsp);
+    CycleMEM mem83(83, m83_req, m83_rsp), mem200(200, m200_req, m200_rsp);
+
+    // Aceleasi rute ca sc_main din L1_network.cpp
+    for (int i = 0; i < 8; i++) eng.configure(i, cfg_trans(cfg_trans::SET_ROUTE, 200, E));
+    for (int i = 0; i < 8; i++) eng.configure(i, cfg_trans(cfg_trans::SET_ROUTE, 20, V));
+    eng.configure(0, cfg_trans(cfg_trans::SET_ROUTE, 83, S));
+    for (int i = 1; i < 8; i++) eng.configure(i, cfg_trans(cfg_trans::SET_ROUTE, 83, V));
+    for (int i = 0; i < 6; i++) eng.configure(i, cfg_trans(cfg_trans::SET_ROUTE, 8, E));
+    eng.configure(6, cfg_trans(cfg_trans::SET_ROUTE, 8, N));
+    for (int i = 0; i < 3; i++) eng.configure(i, cfg_trans(cfg_trans::SET_ROUTE, 100, E));
+    eng.configure(3, cfg_trans(cfg_trans::SET_ROUTE, 100, S));
+
+    while (eng.cycle < 100) { // sc_start(1000, SC_NS)
+        eng.run_cycle();
+        cpu.tick(eng);
+        mem83.tick(eng);
+        mem200.tick(eng);
+    }
+    cout << "CPU 20: " << (cpu.success ? "SUCCESS: Read value matches written value!" : "FAILED") << endl;
+}
+
+// Generatorul de trafic al unui nod (ca TrafficGen din traffic.h, Bernoulli uniform). Fiecare nod are
+// propriul generator aleator, ca rezultatul sa nu depinda de ordinea in care thread-urile trec prin noduri.
+struct NodeTraffic {
+    mt19937 rng;
+    deque<cpacket> source;
+    unsigned long generated, received;
+    double latency_sum;
+
+    NodeTraffic(unsigned seed) : rng(seed), generated(0), received(0), latency_sum(0) {}
+};
+
+// Rezultatul unei rulari pe mesh (checksum-ul trebuie sa fie acelasi pentru orice numar de thread-uri)
+struct MeshResult {
+    unsigned long generated, received;
+    double latency_sum;
+    uint64_t routed;
+    uint64_t checksum;
+    double wall;
+};
+
+// Mesh rows x cols cu rutare XY, cate un generator pe portul local al fiecarui router
+static MeshResult run_mesh(int rows, int cols, double rate, uint64_t cycles, unsigned seed, int threads) {
+    int n = rows * cols;
+    CycleEngine eng(n);
+    if (noc_log_level >= LOG_TRACE) eng.trace = &cout;
+
+    vector<int> inj(n), ej(n);
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            int r = y * cols + x;
+            eng.my_x[r] = (int16_t)x;
+            eng.my_y[r] = (int16_t)y;
+            eng.routing_mode[r] = ROUTE_XY;
+            inj[r] = eng.add_link();
+            ej[r] = eng.add_link();
+            eng.connect(r, L, inj[r], ej[r]);
+        }
+    }
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            int r = y * cols + x;
+            if (x + 1 < cols) {
+                int a = eng.add_link(), b = eng.add_link();
+                eng.connect(r, E, b, a);
+                eng.connect(r + 1, V, a, b);
+            }
+            if (y + 1 < rows) {
+                int a = eng.add_link(), b = eng.add_link();
+                eng.connect(r, S, b, a);
+                eng.connect(r + cols, N, a, b);
+            }
+            if (x == 0) close_port(eng, r, V);
+            if (x == cols - 1) close_port(eng, r, E);
+            if (y == 0) close_port(eng, r, N);
+            if (y == rows - 1) close_port(eng, r, S);
+        }
+    }
+
+    vector<NodeTraffic> nodes;
+    for (int r = 0; r < n; r++) nodes.push_back(NodeTraffic(seed * 7919u + (unsigned)r));
+
+    // Perifericele routerelor [first, last) in ciclul c: ejectare, generare, injectare
+    auto periph = [&](int first, int last, uint64_t c) {
+        uniform_real_distribution<double> uni(0.0, 1.0);
+        for (int r = first; r < last; r++) {
+            NodeTraffic& t = nodes[r];
+            cpacket p;
+            while (eng.eject(ej[r], p)) {
+                t.received++;
+                t.latency_sum += (double)(c - p.inject_cycle);
+            }
+            if (uni(t.rng) < rate) {
+                int d = (int)(uni(t.rng) * (n - 1));
+                if (d >= r) d++;
+                cpacket np(cpacket::REQ_WRITE, xy_id(r % cols, r / cols), xy_id(d % cols, d / cols), (int)t.generated, (int)t.generated);
+                np.inject_cycle = c;
+                t.source.push_back(np);
+                t.generated++;
+            }
+            if (!t.source.empty() && eng.inject(inj[r], t.source.front())) t.source.pop_front();
+        }
+    };
+
+    auto wall_start = chrono::steady_clock::now();
+    eng.run_parallel(cycles, threads, periph);
+    MeshResult res;
+    res.wall = chrono::duration<double>(chrono::steady_clock::now() - wall_start).count();
+
+    res.generated = res.received = 0;
+    res.latency_sum = 0;
+    for (int r = 0; r < n; r++) {
+        res.generated += nodes[r].generated;
+        res.received += nodes[r].received;
+        res.latency_sum += nodes[r].latency_sum;
+    }
+    res.routed = eng.total_routed();
+    res.checksum = 1469598103934665603ull; // FNV-1a peste contoarele de forward si peste receptiile fiecarui nod
+    for (size_t i = 0; i < eng.forwarded.size(); i++) res.checksum = (res.checksum ^ eng.forwarded[i]) * 1099511628211ull;
+    for (int r = 0; r < n; r++) res.checksum = (res.checksum ^ (uint64_t)nodes[r].latency_sum) * 1099511628211ull;
+    return res;
+}
+
+static void print_mesh(int rows, int cols, double rate, uint64_t cycles, int threads, const MeshResult& res) {
+    int n = rows * cols;
+    cout << "Mesh " << rows << "x" << cols << ", rate " << rate << ", " << cycles << " cycles, " << threads << " thread(s): generated "
+         << res.generated << ", received " << res.received << ", accepted " << res.received / ((double)cycles * n) << " pkt/cycle/node"
+         << ", avg latency " << (res.received ? res.latency_sum / res.received : 0.0) << " cycles" << endl;
+    cout << "Wall time: " << res.wall * 1e3 << " ms | " << cycles / res.wall << " cycles/s | "
+         << res.routed / res.wall << " router hops/s | checksum " << hex << res.checksum << dec << endl;
+}
+
+// Curba de speedup: 64, 256 si 1024 de routere, cu 1, 2, 4, ... max_threads thread-uri
+static int run_scaling(double rate, uint64_t cycles, unsigned seed, int max_threads) {
+    int sides[] = { 8, 16, 32 };
+    int mismatches = 0;
+    cout << "routers  threads   wall [ms]   speedup  identical" << endl;
+    for (int side : sides) {
+        MeshResult base = run_mesh(side, side, rate, cycles, seed, 1);
+        for (int t = 1; t <= max_threads; t *= 2) {
+            MeshResult res = (t == 1) ? base : run_mesh(side, side, rate, cycles, seed, t);
+            bool same = res.checksum == base.checksum && res.received == base.received;
+            if (!same) mismatches++;
+            printf("%7d  %7d  %10.1f  %7.2fx  %s\n", side * side, t, res.wall * 1e3, base.wall / res.wall, same ? "yes" : "NO");
+        }
+    }
+    return mismatches ? 1 : 0;
+}
+
+// Liniile [ROUTER] din log-ul SystemC vs cele ale motorului; intoarce numarul de diferente
+static int cross_check(const string& log_path, const string& engine_log) {
+    ifstream f(log_path.c_str());
+    if (!f) {
+        cout << "Cannot open " << log_path << endl;
+        return 1;
+    }
+    vector<string> ref, ours;
+    string line;
+    while (getline(f, line)) {
+        if (line.find("[ROUTER]") != string::npos) ref.push_back(line);
+    }
+    istringstream e(engine_log);
+    while (getline(e, line)) ours.push_back(line);
+
+    size_t n = max(ref.size(), ours.size());
+    int diffs = 0;
+    for (size_t i = 0; i < n; i++) {
+        string a = (i < ref.size()) ? ref[i] : "<missing>";
+        string b = (i < ours.size()) ? ours[i] : "<missing>";
+        if (a == b) continue;
+        if (diffs++ < 5) cout << "MISMATCH at event " << i << ":\n  SystemC: " << a << "\n  engine:  " << b << endl;
+    }
+    if (diffs == 0) cout << "Cross-check vs " << log_path << ": " << ref.size() << " router events, all identical" << endl;
+    else cout << "Cross-check vs " << log_path << ": " << diffs << " of " << n << " events differ" << endl;
+    return diffs;
+}
+
+int main(int argc, char* argv[]) {
+    string scenario = (argc > 1) ? argv[1] : "L1";
+    string check;
+    int rows = 8, cols = 8;
+    double rate = 0.05;
+    uint64_t cycles = 6000;
+    unsigned seed = 1;
+    int threads = 0; // 0 = implicit (1 pentru mesh, 8 pentru scaling)
+
+    for (int i = 2; i < argc; i++) {
+        const char* eq = strchr(argv[i], '=');
+        if (eq == NULL) {
+            cout << "Bad argument '" << argv[i] << "' (expected key=value)" << endl;
+            return 1;
+        }
+        string key(argv[i], eq - argv[i]);
+        const char* val = eq + 1;
+        if (key == "check") check = val;
+        else if (key == "rows") rows = atoi(val);
+        else if (key == "cols") cols = atoi(val);
+        else if (key == "rate") rate = atof(val);
+        else if (key == "cycles") cycles = strtoull(val, NULL, 10);
+        else if (key == "seed") seed = (unsigned)atoi(val);
+        else if (key == "threads") threads = atoi(val);
+        else {
+            cout << "Unknown parameter '" << key << "'" << endl;
+            return 1;
+        }
+    }
+
+    ostringstream engine_log;
+    if (scenario == "L0" || scenario == "L1") {
+        CycleEngine eng(scenario == "L0" ? 1 : 8);
+        if (!check.empty()) eng.trace = &engine_log;
+        else if (noc_log_level >= LOG_TRACE) eng.trace = &cout;
+
+        if (scenario == "L0") run_l0(eng);
+        else run_l1(eng);
+        return check.empty() ? 0 : (cross_check(check, engine_log.str()) ? 1 : 0);
+    }
+    if (scenario == "mesh") {
+        if (rows < 1 || cols < 1 || rows > 256 || cols > 256 || rows * cols < 2) {
+            cout << "Mesh size must be between 1x2 and 256x256" << endl;
+            return 1;
+        }
+        if (threads < 1) threads = 1;
+        print_mesh(rows, cols, rate, cycles, threads, run_mesh(rows, cols, rate, cycles, seed, threads));
+        return 0;
+    }
+    if (scenario == "scaling") return run_scaling(rate, cycles, seed, (threads < 1) ? 8 : threads);
+    cout << "Unknown scenario '" << scenario << "' (L0, L1, mesh or scaling)" << endl;
+    return 1;
+}
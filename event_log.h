@@ -0,0 +1,217 @@
+// event_log.h
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Inregistrare binara a evenimentelor pachetelor din routere, in locul logului text (NOC_LOG=trace), pentru analiza
+// offline cu noc_events.cpp. Fiecare router scrie evenimente de dimensiune fixa intr-un buffer propriu, iar bufferul
+// plin pleaca in fisier dintr-o bucata, deci in fisier evenimentele sunt grupate pe routere si nu sunt sortate dupa timp.
+// Fisierul: antet (magic "NOCEVT1\0", dimensiunea unui eveniment, 0, unitati de timp per ciclu), evenimentele, tabela
+// cu numele routerelor (id, lungime, nume) si un footer de 16 octeti (offset-ul tabelei, numarul de routere, "NAME").
+// Un fisier fara footer (simulare oprita) ramane citibil, doar fara nume.
+// Nu depinde de SystemC, ca sa poata fi citit si de unelte offline.
+
+enum EventKind {
+    EV_INJECT = 0,  // pachetul intra in retea: castiga arbitrarea pe un port cu periferic (edge_port)
+    EV_ARB = 1,     // castiga arbitrarea pe intrarea in_port, spre out_port
+    EV_FORWARD = 2, // a fost scris in iesirea out_port (dupa ce iesirea a avut loc)
+    EV_DROP = 3,    // aruncat: out_port = portul dezactivat, sau EV_NO_PORT daca nu avea ruta
+    EV_EJECT = 4    // iese din retea: scris pe un port cu periferic
+};
+const int NUM_EVENT_KINDS = 5;
+const char* EventKindNames[] = { "INJECT", "ARB", "FORWARD", "DROP", "EJECT" };
+const uint8_t EV_NO_PORT = 0xFF;
+
+struct noc_event {
+    uint64_t time;    // sc_time::value() (unitatea de rezolutie a kernelului)
+    uint64_t inject;  // inject_time al pachetului, in aceeasi unitate
+    int32_t src_id;
+    int32_t dst_id;
+    int32_t address;
+    int32_t tag;
+    uint16_t router;  // id-ul din EventRecorder::add_router
+    uint8_t kind;     // EventKind
+    uint8_t in_port;  // PortID sau EV_NO_PORT
+    uint8_t out_port;
+    uint8_t type;     // packet::Type
+    uint8_t flit;     // packet::Flit
+    uint8_t pad;
+};
+static_assert(sizeof(noc_event) == 40, "noc_event must stay 40 bytes (file format)");
+
+static const char EVENT_MAGIC[8] = { 'N', 'O', 'C', 'E', 'V', 'T', '1', '\0' };
+static const size_t EVENT_HEADER_BYTES = 24;
+static const char EVENT_NAMES_TAG[4] = { 'N', 'A', 'M', 'E' };
+
+class EventRecorder {
+public:
+    static const size_t RING_EVENTS = 1 << 13; // 320 KB per router
+
+    // Bufferul unui router: push() e un memcpy, scrierea in fisier se face doar cand se umple
+    struct Ring {
+        EventRecorder* owner;
+        uint16_t id;
+        size_t n;
+        std::vector<noc_event> buf;
+
+        void push(noc_event& e) {
+            e.router = id;
+            buf[n++] = e;
+            if (n == buf.size()) owner->flush(*this);
+        }
+    };
+
+    EventRecorder() : f(NULL), failed(false), written(0) {}
+    ~EventRecorder() { close(); }
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    // cycle = cate unitati de timp are un ciclu de router (pentru unelte: utilizare / latenta in cicluri)
+    bool open(const std::string& path, uint64_t cycle) {
+        close();
+        f = fopen(path.c_str(), "wb");
+        failed = (f == NULL);
+        if (failed) return false;
+        uint32_t sizes[2] = { (uint32_t)sizeof(noc_event), 0 };
+        write(EVENT_MAGIC, sizeof(EVENT_MAGIC));
+        write(sizes, sizeof(sizes));
+        write(&cycle, sizeof(cycle));
+        return !failed;
+    }
+
+    bool is_open() const { return f != NULL; }
+
+    Ring* add_router(const std::string& name) {
+        Ring* r = new Ring();
+        r->owner = this;
+        r->id = (uint16_t)rings.size();
+        r->n = 0;
+        r->buf.resize(RING_EVENTS);
+        rings.push_back(std::unique_ptr<Ring>(r));
+        names.push_back(name);
+        return r;
+    }
+
+    void flush(Ring& r) {
+        if (r.n == 0) return;
+        if (f) write(r.buf.data(), r.n * sizeof(noc_event));
+        written += r.n;
+        r.n = 0;
+    }
+
+    uint64_t events() const {
+        uint64_t n = written;
+        for (size_t i = 0; i < rings.size(); i++) n += rings[i]->n;
+        return n;
+    }
+
+    // Scrie ce a ramas in buffere si tabela de nume; false daca vreo scriere a esuat (ex. disc plin)
+    bool close() {
+        if (f == NULL) return !failed;
+        for (size_t i = 0; i < rings.size(); i++) flush(*rings[i]);
+        uint64_t names_at = EVENT_HEADER_BYTES + written * sizeof(noc_event);
+        for (size_t i = 0; i < names.size(); i++) {
+            uint16_t hdr[2] = { (uint16_t)i, (uint16_t)names[i].size() };
+            write(hdr, sizeof(hdr));
+            write(names[i].data(), names[i].size());
+        }
+        uint32_t count = (uint32_t)names.size();
+        write(&names_at, sizeof(names_at));
+        write(&count, sizeof(count));
+        write(EVENT_NAMES_TAG, sizeof(EVENT_NAMES_TAG));
+        if (fclose(f) != 0) failed = true;
+        f = NULL;
+        return !failed;
+    }
+
+private:
+    void write(const void* p, size_t n) {
+        if (!failed && fwrite(p, 1, n, f) != n) failed = true;
+    }
+
+    FILE* f;
+    bool failed;
+    uint64_t written; // evenimente deja in fisier
+    std::vector<std::unique_ptr<Ring> > rings;
+    std::vector<std::string> names;
+};
+
+// Citirea unui fisier scris de EventRecorder (tot, in memorie: e pentru analiza offline)
+struct EventFile {
+    uint64_t cycle;
+    std::vector<noc_event> events;
+    std::vector<std::string> router_names; // gol daca fisierul nu are footer
+    std::string error;
+
+    bool load(const std::string& path) {
+        FILE* in = fopen(path.c_str(), "rb");
+        if (in == NULL) return fail("cannot open " + path);
+        char magic[8];
+        uint32_t sizes[2];
+        if (fread(magic, 1, 8, in) != 8 || memcmp(magic, EVENT_MAGIC, 8) != 0 || fread(sizes, 1, 8, in) != 8 ||
+            fread(&cycle, 1, 8, in) != 8) {
+            fclose(in);
+            return fail(path + " is not an event file");
+        }
+        if (sizes[0] != sizeof(noc_event)) {
+            fclose(in);
+            return fail(path + ": unsupported event size " + std::to_string(sizes[0]));
+        }
+        fseeko(in, 0, SEEK_END);
+        uint64_t file_size = (uint64_t)ftello(in);
+
+        // Footer-ul spune unde se termina evenimentele; fara el, tot restul fisierului sunt evenimente
+        uint64_t events_end = file_size;
+        uint64_t names_at = 0;
+        uint32_t count = 0;
+        char tag[4];
+        if (file_size >= EVENT_HEADER_BYTES + 16) {
+            fseeko(in, (off_t)(file_size - 16), SEEK_SET);
+            if (fread(&names_at, 8, 1, in) == 1 && fread(&count, 4, 1, in) == 1 && fread(tag, 1, 4, in) == 4 &&
+                memcmp(tag, EVENT_NAMES_TAG, 4) == 0 && names_at >= EVENT_HEADER_BYTES && names_at <= file_size - 16) {
+                events_end = names_at;
+            } else {
+                count = 0;
+            }
+        }
+
+        events.resize((events_end - EVENT_HEADER_BYTES) / sizeof(noc_event));
+        fseeko(in, (off_t)EVENT_HEADER_BYTES, SEEK_SET);
+        if (fread(events.data(), sizeof(noc_event), events.size(), in) != events.size()) {
+            fclose(in);
+            return fail(path + ": truncated event data");
+        }
+
+        router_names.clear();
+        fseeko(in, (off_t)names_at, SEEK_SET);
+        for (uint32_t i = 0; i < count; i++) {
+            uint16_t hdr[2];
+            if (fread(hdr, sizeof(hdr), 1, in) != 1) break;
+            std::string name(hdr[1], ' ');
+            if (hdr[1] > 0 && fread(&name[0], 1, hdr[1], in) != hdr[1]) break;
+            if (hdr[0] >= router_names.size()) router_names.resize(hdr[0] + 1);
+            router_names[hdr[0]] = name;
+        }
+        fclose(in);
+        return true;
+    }
+
+    std::string router_name(int id) const {
+        if (id < (int)router_names.size() && !router_names[id].empty()) return router_names[id];
+        return "R" + std::to_string(id);
+    }
+
+private:
+    bool fail(const std::string& msg) {
+        error = msg;
+        return false;
+    }
+};
+
+#endif
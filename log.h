@@ -0,0 +1,49 @@
+// log.h
+#ifndef LOG_H
+#define LOG_H
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+// Nivelurile de log (fiecare include nivelurile de deasupra)
+enum LogLevel {
+    LOG_NONE = 0,
+    LOG_ERROR = 1, // erori de configurare / verificari esuate
+    LOG_INFO = 2,  // rezultate si mesaje rare (implicit)
+    LOG_DEBUG = 3, // cate o linie pe tranzactie in CPU / MEM si pe fiecare comanda de config
+    LOG_TRACE = 4  // cate o linie pe fiecare hop al fiecarui pachet (logul complet din README)
+};
+
+// Switch de compilare: tot ce e peste NOC_LOG_MAX_LEVEL dispare complet din binar
+// (conditia e constanta, deci compilatorul elimina si formatarea, nu doar afisarea).
+// Ex: -DNOC_LOG_MAX_LEVEL=LOG_INFO
+#ifndef NOC_LOG_MAX_LEVEL
+#define NOC_LOG_MAX_LEVEL LOG_TRACE
+#endif
+
+// Nivelul la runtime vine din variabila de mediu NOC_LOG (error/info/debug/trace sau 0-4), implicit info.
+// La nivelul implicit calea critica (router, MEM, CPU) nu face niciun I/O.
+static int noc_log_level_from_env() {
+    const char* env = std::getenv("NOC_LOG");
+    if (env == NULL) return LOG_INFO;
+    if (env[0] >= '0' && env[0] <= '4') return env[0] - '0';
+    if (std::strcmp(env, "none") == 0)  return LOG_NONE;
+    if (std::strcmp(env, "error") == 0) return LOG_ERROR;
+    if (std::strcmp(env, "debug") == 0) return LOG_DEBUG;
+    if (std::strcmp(env, "trace") == 0) return LOG_TRACE;
+    return LOG_INFO;
+}
+
+static int noc_log_level = noc_log_level_from_env();
+
+// Folosire: NOC_LOG(LOG_TRACE, "@" << sc_time_stamp() << " [ROUTER] ..." << endl);
+// Argumentul e evaluat (si formatat) doar daca nivelul e activ.
+#define NOC_LOG(lvl, msg) \
+    do { \
+        if ((lvl) <= NOC_LOG_MAX_LEVEL && (lvl) <= noc_log_level) { \
+            std::cout << msg; \
+        } \
+    } while (0)
+
+#endif
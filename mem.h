@@ -2,8 +2,12 @@
 #define MEM_H
 
 #include <systemc.h>
-#include <map>
+#include <deque>
+#include <vector>
 #include "utils.h"
+#include "log.h"
+#include "mem_store.h"
+#include "checkpoint.h"
 
 SC_MODULE(MEM) {
     sc_fifo_in<packet>  in_port;  // Intrare: Primește Cereri (REQ_WRITE / REQ_READ)
@@ -11,82 +15,294 @@ SC_MODULE(MEM) {
     
     int my_id; //adresa memoriei in retea
 
-    // Aici practic vom stoca datele (addr -> data)
-    std::map<int, int> memory_space; 
+    // Aici practic vom stoca datele (addr -> data), in pagini alocate la prima scriere
+    PagedStore memory_space;
+
+    // Timing: implicit fiecare cerere dureaza 10 ns, una dupa alta. Cu set_timing() latenta depinde de
+    // banca si de row buffer, iar cererile pe banci diferite se suprapun (raspunsurile pot iesi in alta ordine).
+    bool banked;
+    BankTiming timing;
+    unsigned long requests;
+    sc_time total_service; // suma (raspuns gata - cerere primita), pentru latenta medie a memoriei
+
+    // Se apeleaza inainte de sc_start
+    void set_timing(const BankTiming& t) {
+        timing = t;
+        banked = true;
+    }
+
+    // Porneste cu continutul unei imagini binare (int32 per cuvant, primul la adresa base), mapata cu mmap.
+    // Se apeleaza la elaborare, inainte de sc_start: incarcarea nu costa timp simulat si nu copiaza fisierul.
+    bool load_image(const std::string& path, int base = 0) {
+        long words = memory_space.load_image(path.c_str(), base);
+        if (words < 0) {
+            NOC_LOG(LOG_ERROR, "[MEM " << my_id << "] ERROR: cannot load image " << path << endl);
+            return false;
+        }
+        NOC_LOG(LOG_INFO, "[MEM " << my_id << "] Loaded image " << path << ": " << words << " words at address " << base << endl);
+        return true;
+    }
+
+    // Scrie continutul final intr-o imagine (reincarcabila cu load_image(path, base) cu base-ul afisat)
+    bool dump_image(const std::string& path) {
+        int base = 0;
+        long words = memory_space.dump_image(path.c_str(), base);
+        if (words < 0) {
+            NOC_LOG(LOG_ERROR, "[MEM " << my_id << "] ERROR: cannot dump image " << path << endl);
+            return false;
+        }
+        NOC_LOG(LOG_INFO, "[MEM " << my_id << "] Dumped image " << path << ": " << words << " words from address " << base << endl);
+        return true;
+    }
+
+    double avg_service_ns() const { return requests ? total_service.to_seconds() * 1e9 / requests : 0.0; }
 
     void behavior() {
+        if (resume_at > SC_ZERO_TIME) { // reluare dintr-un checkpoint: terminam cererea care era in lucru
+            wait(resume_at);
+            if (burst_words > 0) {
+                receive_burst();
+                respond(packet::RSP_ACK, 0, 1);
+            } else if (!reply.empty()) {
+                send_reply();
+            }
+        }
+
         while(true) {
 
             packet req = in_port.read(); // deci practic memoria sta inactiva si asteapta cereri
-            
-            packet rsp; 
-            bool send_response = false; 
+            cur_req = req;
 
             // afisam ce am primit de la CPU
-            cout << "@" << sc_time_stamp() << " [MEM " << my_id << "] RECV: " << req << endl;
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [MEM " << my_id << "] RECV: " << req << endl);
 
             // Procesam raspunsul in functie de tipul cererii
             switch(req.type) {
                 // --- Write ---
                 case packet::REQ_WRITE:
-                    memory_space[req.address] = req.data; // scriem in memorie
+                    memory_space.write(req.address, req.data); // scriem in memorie
                     
-                    cout << "      ---> [WRITE OP] Written value " << req.data 
-                         << " at address " << req.address << endl;
+                    NOC_LOG(LOG_DEBUG, "      ---> [WRITE OP] Written value " << req.data 
+                         << " at address " << req.address << endl);
+
+                    // Burst: restul flit-urilor vin imediat in spatele capului (wormhole)
+                    if (!req.is_tail()) {
+                        burst_words = 1;
+                        receive_burst();
+                    }
                     
                     // Construim confirmarea (ACK)
-                    rsp.type = packet::RSP_ACK;
-                    rsp.data = 0; // Nu contează la ACK
-                    send_response = true;
+                    respond(packet::RSP_ACK, 0, 1); // datele nu conteaza la ACK
                     break;
 
                 // --- Read ---
-                case packet::REQ_READ:
+                case packet::REQ_READ: {
                     int found_value;
                     
-                    // verificam daca adresa exista in memorie
-                    if (memory_space.find(req.address) != memory_space.end()) {
-                        found_value = memory_space[req.address];
+                    // verificam daca pagina adresei exista in memorie. PagedStore nu tine minte fiecare cuvant:
+                    // un cuvant nescris dintr-o pagina deja atinsa se citeste tot 0, dar fara mesajul de mai jos.
+                    if (memory_space.is_mapped(req.address)) {
+                        found_value = memory_space.read(req.address);
                     } else {
-                        // Dacă adresa nu a fost scrisă niciodată, returnăm 0 (sau o eroare)
+                        // Dacă pagina nu a fost scrisă niciodată, returnăm 0 (sau o eroare)
                         found_value = 0;
-                        cout << "      ---> [READ OP] Address empty. Returning 0." << endl;
+                        NOC_LOG(LOG_DEBUG, "      ---> [READ OP] Page unmapped (never written). Returning 0." << endl);
                     }
 
-                    cout << "      ---> [READ OP] Read value " << found_value 
-                         << " from address " << req.address << endl;
+                    NOC_LOG(LOG_DEBUG, "      ---> [READ OP] Read value " << found_value 
+                         << " from address " << req.address << endl);
+
+                    // Burst: raspundem cu req.len cuvinte consecutive, intr-un singur pachet cu mai multe flit-uri
+                    int burst = 1;
+                    if (req.len > 1) {
+                        burst = req.len;
+                        NOC_LOG(LOG_DEBUG, "      ---> [READ OP] Burst: " << burst << " words from address " << req.address << endl);
+                    }
 
                     // Construim pachetul de date
-                    rsp.type = packet::RSP_DATA;
-                    rsp.data = found_value;
-                    send_response = true;
+                    respond(packet::RSP_DATA, found_value, burst);
                     break;
+                }
 
                 default:
                     // Ignorăm pachete de tip ACK/DATA dacă ajung din greșeală aici
-                    cout << "      ---> [IGNORED] Unexpected packet type." << endl;
+                    NOC_LOG(LOG_ERROR, "      ---> [IGNORED] Unexpected packet type." << endl);
                     break;
             }
+        }
+    }
 
-            // trimitem raspunsul inapoi la CPU
-            if (send_response) {
-                // Inversăm rolurile: MEM devin Sursa, CPU-ul devine Destinatia
-                rsp.src_id = my_id;       
-                rsp.dst_id = req.src_id;  
-                rsp.address = req.address;
-
-                wait(10, SC_NS);
-                
-                out_port.write(rsp);
-                cout << "      ---> [REPLY] Sending response to CPU " << rsp.dst_id << endl;
+    // Restul unui WRITE in burst: cate un cuvant pe adresa urmatoare, pana la TAIL (burst_words = cuvinte deja scrise)
+    void receive_burst() {
+        packet f;
+        do {
+            f = in_port.read();
+            memory_space.write(cur_req.address + burst_words, f.data);
+            burst_words++;
+        } while (!f.is_tail());
+        NOC_LOG(LOG_DEBUG, "      ---> [WRITE OP] Burst: " << burst_words << " words written from address " << cur_req.address << endl);
+        burst_words = 0;
+    }
+
+    // Trimite raspunsul la cur_req inapoi la CPU (burst > 1 = RSP_DATA cu mai multe flit-uri)
+    void respond(packet::Type type, int data, int burst) {
+        const packet& req = cur_req;
+
+        // Inversăm rolurile: MEM devin Sursa, CPU-ul devine Destinatia
+        packet rsp;
+        rsp.type = type;
+        rsp.data = data;
+        rsp.src_id = my_id;       
+        rsp.dst_id = req.src_id;  
+        rsp.address = req.address;
+        rsp.tag = req.tag;        // CPU-ul potriveste raspunsul cu cererea dupa tag
+        rsp.len = (req.type == packet::REQ_WRITE) ? req.len : burst; // ACK-ul confirma tot burst-ul
+        rsp.inject_time = req.inject_time; // raspunsul mosteneste varsta tranzactiei (OLDEST_FIRST o serveste primul)
+
+        std::vector<packet> flits;
+        if (burst == 1) {
+            flits.push_back(rsp);
+        } else {
+            for (int i = 0; i < burst; i++) {
+                flits.push_back(packet::make_flit(rsp, i, burst, memory_space.read(req.address + i)));
             }
         }
+        requests++;
+
+        if (!banked) {
+            reply = flits;
+            reply_pos = 0;
+            reply_at = sc_time_stamp() + sc_time(10, SC_NS);
+            total_service += sc_time(10, SC_NS);
+            send_reply();
+        } else {
+            // Nu blocam: calculam cand e gata raspunsul si il lasam pe responder() sa-l trimita,
+            // ca sa putem primi intre timp cereri pentru alte banci
+            int words = (req.len > 1) ? req.len : 1;
+            double now = sc_time_stamp().to_seconds() * 1e9;
+            sc_time ready(timing.access(req.address, words, now), SC_NS);
+            total_service += ready - sc_time_stamp();
+            NOC_LOG(LOG_DEBUG, "      ---> [BANK " << timing.bank_of(req.address) << "] response ready @" << ready << endl);
+            schedule(ready, flits);
+        }
+    }
+
+    // Modul fara banci: raspunsul pleaca la reply_at (10 ns dupa cerere), flit cu flit
+    void send_reply() {
+        if (reply_at > sc_time_stamp()) wait(reply_at - sc_time_stamp());
+        for (; reply_pos < reply.size(); reply_pos++) out_port.write(reply[reply_pos]);
+        NOC_LOG(LOG_DEBUG, "      ---> [REPLY] Sending response to CPU " << reply[0].dst_id << endl);
+        reply.clear();
+        reply_pos = 0;
+    }
+
+    // Trimite raspunsurile din modul cu banci, in ordinea in care devin gata
+    void responder() {
+        if (resume_at > SC_ZERO_TIME) wait(resume_at);
+
+        while (true) {
+            while (pending.empty()) wait(pending_event);
+
+            // O cerere noua poate fi gata mai devreme decat cea pe care o asteptam: ne trezim si la pending_event
+            if (pending_sent == 0 && pending.front().ready > sc_time_stamp()) {
+                wait(pending.front().ready - sc_time_stamp(), pending_event);
+                continue;
+            }
+
+            // behavior() poate adauga raspunsuri cat timp suntem blocati, deci nu tinem referinte in deque
+            for (; pending_sent < pending.front().flits.size(); pending_sent++) out_port.write(pending.front().flits[pending_sent]);
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [MEM " << my_id << "] REPLY to CPU " << pending.front().flits[0].dst_id << endl);
+            pending.pop_front();
+            pending_sent = 0;
+        }
+    }
+
+    // Checkpoint: continutul memoriei (doar paginile atinse), timing-ul si cererile in lucru / raspunsurile in asteptare
+    void save_state(ckpt_out& out) const {
+        out.section("MEM ");
+        memory_space.save_state(out);
+        out.put<int32_t>(banked);
+        timing.save_state(out);
+        out.put(requests);
+        out.time(total_service);
+        out.pkt(cur_req);
+        out.put<int32_t>(burst_words);
+        save_flits(out, reply);
+        out.put<uint32_t>((uint32_t)reply_pos);
+        out.time(reply_at);
+        out.put<uint32_t>((uint32_t)pending.size());
+        for (size_t i = 0; i < pending.size(); i++) {
+            out.time(pending[i].ready);
+            save_flits(out, pending[i].flits);
+        }
+        out.put<uint32_t>((uint32_t)pending_sent);
+    }
+
+    void load_state(ckpt_in& in, const sc_time& at) {
+        if (!in.section("MEM ")) return;
+        memory_space.load_state(in);
+        banked = in.get<int32_t>() != 0;
+        timing.load_state(in);
+        requests = in.get<unsigned long>();
+        total_service = in.time();
+        cur_req = in.pkt();
+        burst_words = in.get<int32_t>();
+        load_flits(in, reply);
+        reply_pos = in.get<uint32_t>();
+        reply_at = in.time();
+        pending.resize(in.get<uint32_t>());
+        for (size_t i = 0; i < pending.size() && in.ok(); i++) {
+            pending[i].ready = in.time();
+            load_flits(in, pending[i].flits);
+        }
+        pending_sent = in.get<uint32_t>();
+        resume_at = at;
     }
 
     SC_HAS_PROCESS(MEM);
 
-    MEM(sc_module_name name, int id) : sc_module(name), my_id(id) {
+    MEM(sc_module_name name, int id)
+        : sc_module(name), my_id(id), banked(false), requests(0), pending_sent(0), burst_words(0), reply_pos(0) {
         SC_THREAD(behavior);
+        SC_THREAD(responder);
+    }
+
+private:
+    struct PendingResponse {
+        sc_time ready;
+        std::vector<packet> flits;
+    };
+
+    std::deque<PendingResponse> pending; // sortat dupa ready (la egalitate, in ordinea sosirii)
+    size_t pending_sent;                 // flit-uri din pending.front() deja trimise
+    sc_event pending_event;
+
+    // Cererea in lucru, tinuta in membri ca sa poata fi salvata intr-un checkpoint
+    packet cur_req;
+    int burst_words;           // > 0: primim restul unui WRITE in burst, atatea cuvinte sunt deja scrise
+    std::vector<packet> reply; // modul fara banci: raspunsul care asteapta reply_at sau loc in out_port
+    size_t reply_pos;
+    sc_time reply_at;
+    sc_time resume_at;         // > 0: starea vine dintr-un checkpoint salvat la momentul asta
+
+    static void save_flits(ckpt_out& out, const std::vector<packet>& flits) {
+        out.put<uint32_t>((uint32_t)flits.size());
+        for (size_t i = 0; i < flits.size(); i++) out.pkt(flits[i]);
+    }
+
+    static void load_flits(ckpt_in& in, std::vector<packet>& flits) {
+        flits.resize(in.get<uint32_t>());
+        for (size_t i = 0; i < flits.size(); i++) flits[i] = in.pkt();
+    }
+
+    void schedule(const sc_time& ready, const std::vector<packet>& flits) {
+        std::deque<PendingResponse>::iterator it = pending.end();
+        while (it != pending.begin() && (it - 1)->ready > ready) --it;
+        PendingResponse r;
+        r.ready = ready;
+        r.flits = flits;
+        pending.insert(it, r);
+        pending_event.notify(SC_ZERO_TIME);
     }
 };
 
@@ -0,0 +1,282 @@
+// mem_store.h
+#ifndef MEM_STORE_H
+#define MEM_STORE_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Memorie rara (sparse) paginata: spatiul de adrese e impartit in pagini de PAGE_WORDS cuvinte,
+// alocate lenes la prima scriere. Directorul de pagini e un vector plat indexat cu numarul paginii,
+// deci un acces = un index in director + un index in pagina (O(1), fara pointer chasing ca in std::map).
+// Adresele sunt tratate ca unsigned pe 32 de biti; directorul creste doar pana la cea mai mare pagina atinsa.
+// Paginile pot veni si dintr-o imagine binara mapata cu mmap (load_image), fara copiere.
+// Nu depinde de SystemC, ca sa poata fi folosita si in benchmark-uri.
+class PagedStore {
+public:
+    PagedStore() : allocated(0), mapped(0) {}
+    ~PagedStore() { clear(); }
+    PagedStore(const PagedStore&) = delete;
+    PagedStore& operator=(const PagedStore&) = delete;
+
+    static const int PAGE_BITS = 12;                // 4096 cuvinte (16 KB) pe pagina
+    static const int PAGE_WORDS = 1 << PAGE_BITS;
+    static const uint32_t PAGE_MASK = PAGE_WORDS - 1;
+
+    // Valoarea de la addr, 0 daca nu a fost scrisa niciodata (citirea nu aloca nimic)
+    int read(int addr) const {
+        uint32_t page = (uint32_t)addr >> PAGE_BITS;
+        if (page >= dir.size() || !dir[page]) return 0;
+        return dir[page][(uint32_t)addr & PAGE_MASK];
+    }
+
+    void write(int addr, int value) {
+        page_for((uint32_t)addr >> PAGE_BITS)[(uint32_t)addr & PAGE_MASK] = value;
+    }
+
+    // True daca pagina care contine addr a fost alocata (adica s-a scris ceva in vecinatate)
+    bool is_mapped(int addr) const {
+        uint32_t page = (uint32_t)addr >> PAGE_BITS;
+        return page < dir.size() && dir[page];
+    }
+
+    void clear() {
+        dir.clear();
+        owned.clear();
+        for (size_t i = 0; i < maps.size(); i++) munmap(maps[i].addr, maps[i].len);
+        maps.clear();
+        allocated = 0;
+        mapped = 0;
+    }
+
+    size_t pages_allocated() const { return allocated; }
+    size_t pages_mapped() const { return mapped; }
+
+    // Memoria host alocata de noi: paginile proprii + directorul. Paginile mapate din imagini nu intra aici:
+    // kernelul le incarca din fisier doar cand sunt atinse si le copiaza doar cand sunt scrise.
+    size_t host_bytes() const {
+        return allocated * PAGE_WORDS * sizeof(int) + dir.capacity() * sizeof(dir[0]) + owned.capacity() * sizeof(owned[0]);
+    }
+
+    // Incarca o imagine binara: cuvinte int32 (in ordinea de octeti a host-ului), primul la adresa base.
+    // Daca base e aliniat la pagina, paginile complete din fisier sunt mapate direct (mmap MAP_PRIVATE):
+    // incarcarea nu copiaza nimic, iar scrierile ulterioare fac copy-on-write si nu modifica fisierul.
+    // Restul (ultima pagina partiala sau un base nealiniat) e copiat cuvant cu cuvant.
+    // Intoarce numarul de cuvinte incarcate, sau -1 daca fisierul nu poate fi citit.
+    long load_image(const char* path, int base) {
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return -1;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return -1;
+        }
+        size_t words = (size_t)st.st_size / sizeof(int);
+        if (words == 0) {
+            close(fd);
+            return 0;
+        }
+        size_t len = words * sizeof(int);
+        void* m = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd); // maparea ramane valida si dupa close
+        if (m == MAP_FAILED) return -1;
+        maps.push_back(Mapping{m, len});
+
+        int* img = (int*)m;
+        size_t done = 0;
+        if (((uint32_t)base & PAGE_MASK) == 0) {
+            uint32_t first = (uint32_t)base >> PAGE_BITS;
+            size_t full = words / PAGE_WORDS;
+            if (first + full > dir.size()) {
+                dir.resize(first + full);
+                owned.resize(first + full);
+            }
+            for (size_t i = 0; i < full; i++) {
+                if (owned[first + i]) {
+                    owned[first + i].reset();
+                    allocated--;
+                } else if (!dir[first + i]) {
+                    mapped++;
+                }
+                dir[first + i] = img + i * PAGE_WORDS;
+            }
+            done = full * PAGE_WORDS;
+        }
+        for (size_t i = done; i < words; i++) write(base + (int)i, img[i]);
+        return (long)words;
+    }
+
+    // Scrie intr-o imagine binara (acelasi format ca load_image) toate adresele de la prima pana la ultima
+    // pagina atinsa; base primeste adresa primului cuvant. Paginile neatinse raman gauri in fisier
+    // (ftruncate + mmap MAP_SHARED), deci nu ocupa spatiu pe disc. Intoarce numarul de cuvinte sau -1.
+    long dump_image(const char* path, int& base) const {
+        size_t lo = 0, hi = dir.size();
+        while (lo < hi && !dir[lo]) lo++;
+        while (hi > lo && !dir[hi - 1]) hi--;
+        base = (int)(lo << PAGE_BITS);
+
+        int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return -1;
+        size_t words = (hi - lo) * PAGE_WORDS;
+        size_t len = words * sizeof(int);
+        if (len == 0) {
+            close(fd);
+            return 0;
+        }
+        if (ftruncate(fd, (off_t)len) != 0) {
+            close(fd);
+            return -1;
+        }
+        void* m = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (m == MAP_FAILED) return -1;
+        int* out = (int*)m;
+        for (size_t p = lo; p < hi; p++) {
+            if (dir[p]) memcpy(out + (p - lo) * PAGE_WORDS, dir[p], PAGE_WORDS * sizeof(int));
+        }
+        munmap(m, len);
+        return (long)words;
+    }
+
+    // Checkpoint: doar paginile atinse (numarul lor, apoi index + continut pentru fiecare).
+    // Out / In trebuie sa aiba raw(ptr, n) si (In) ok() / fail(mesaj), ca ckpt_out / ckpt_in din checkpoint.h.
+    template <class Out>
+    void save_state(Out& out) const {
+        uint32_t n = 0;
+        for (size_t p = 0; p < dir.size(); p++) n += dir[p] ? 1 : 0;
+        out.raw(&n, sizeof(n));
+        for (uint32_t p = 0; p < dir.size(); p++) {
+            if (!dir[p]) continue;
+            out.raw(&p, sizeof(p));
+            out.raw(dir[p], PAGE_WORDS * sizeof(int));
+        }
+    }
+
+    template <class In>
+    void load_state(In& in) {
+        clear();
+        uint32_t n = 0;
+        in.raw(&n, sizeof(n));
+        for (uint32_t i = 0; i < n && in.ok(); i++) {
+            uint32_t p = 0;
+            in.raw(&p, sizeof(p));
+            if (p >= (1u << (32 - PAGE_BITS))) {
+                in.fail("invalid memory page in checkpoint");
+                return;
+            }
+            in.raw(page_for(p), PAGE_WORDS * sizeof(int));
+        }
+    }
+
+private:
+    int* page_for(uint32_t page) {
+        if (page >= dir.size()) {
+            dir.resize(page + 1);
+            owned.resize(page + 1);
+        }
+        if (!dir[page]) {
+            owned[page].reset(new int[PAGE_WORDS]()); // paginile noi sunt zero, ca adresele nescrise
+            dir[page] = owned[page].get();
+            allocated++;
+        }
+        return dir[page];
+    }
+
+    struct Mapping {
+        void* addr;
+        size_t len;
+    };
+
+    std::vector<int*> dir;                     // dir[page] = pagina (proprie sau mapata) sau null daca nu a fost atinsa
+    std::vector<std::unique_ptr<int[]>> owned; // paginile alocate de noi (null pentru cele mapate)
+    std::vector<Mapping> maps;                 // imaginile mapate, eliberate in clear()
+    size_t allocated;
+    size_t mapped;
+};
+
+// Model de timing cu banci si row buffer (politica open-page, ca la DRAM):
+// adresa -> banca = (addr / row_words) % num_banks, rand = addr / (row_words * num_banks),
+// deci cuvintele consecutive stau in acelasi rand, iar randurile consecutive cad pe banci diferite.
+// Un acces in randul deja deschis costa t_hit, altfel t_miss (precharge + activate + citire);
+// fiecare cuvant in plus dintr-un burst mai costa t_word. O banca lucreaza la o singura cerere o data,
+// dar bancile diferite lucreaza in paralel. Timpii sunt in ns, ca modelul sa nu depinda de SystemC.
+struct BankTiming {
+    int num_banks;
+    int row_words;
+    double t_hit;
+    double t_miss;
+    double t_word;
+
+    unsigned long row_hits;
+    unsigned long row_misses;
+
+    BankTiming(int banks = 8, int row = 256, double hit = 10, double miss = 30, double word = 1)
+        : num_banks(banks), row_words(row), t_hit(hit), t_miss(miss), t_word(word), row_hits(0), row_misses(0),
+          open_row(banks, -1), busy_until(banks, 0.0) {}
+
+    int bank_of(int addr) const { return (int)(((uint32_t)addr / row_words) % num_banks); }
+    long row_of(int addr) const { return (long)((uint32_t)addr / row_words / num_banks); }
+
+    // Un acces de words cuvinte care incepe la addr si soseste la momentul now (ns).
+    // Intoarce momentul la care datele sunt gata si ocupa banca pana atunci.
+    double access(int addr, int words, double now) {
+        int b = bank_of(addr);
+        long r = row_of(addr);
+        double start = (busy_until[b] > now) ? busy_until[b] : now;
+        double lat;
+        if (open_row[b] == r) {
+            lat = t_hit;
+            row_hits++;
+        } else {
+            lat = t_miss;
+            row_misses++;
+            open_row[b] = r;
+        }
+        busy_until[b] = start + lat + (words - 1) * t_word;
+        return busy_until[b];
+    }
+
+    // Checkpoint: parametrii, contoarele si starea fiecarei banci (rand deschis, ocupata pana cand)
+    template <class Out>
+    void save_state(Out& out) const {
+        int32_t geom[2] = { num_banks, row_words };
+        double times[3] = { t_hit, t_miss, t_word };
+        unsigned long counters[2] = { row_hits, row_misses };
+        out.raw(geom, sizeof(geom));
+        out.raw(times, sizeof(times));
+        out.raw(counters, sizeof(counters));
+        out.raw(open_row.data(), num_banks * sizeof(long));
+        out.raw(busy_until.data(), num_banks * sizeof(double));
+    }
+
+    template <class In>
+    void load_state(In& in) {
+        int32_t geom[2];
+        double times[3];
+        unsigned long counters[2];
+        in.raw(geom, sizeof(geom));
+        in.raw(times, sizeof(times));
+        in.raw(counters, sizeof(counters));
+        if (!in.ok() || geom[0] < 1 || geom[0] > (1 << 16) || geom[1] < 1) {
+            in.fail("invalid bank timing in checkpoint");
+            return;
+        }
+        *this = BankTiming(geom[0], geom[1], times[0], times[1], times[2]);
+        row_hits = counters[0];
+        row_misses = counters[1];
+        in.raw(open_row.data(), num_banks * sizeof(long));
+        in.raw(busy_until.data(), num_banks * sizeof(double));
+    }
+
+private:
+    std::vector<long> open_row;     // randul deschis in fiecare banca (-1 = niciunul)
+    std::vector<double> busy_until; // pana cand e ocupata fiecare banca
+};
+
+#endif
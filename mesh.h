@@ -0,0 +1,209 @@
+// mesh.h
+#ifndef MESH_H
+#define MESH_H
+
+#include <systemc.h>
+#include <vector>
+#include <string>
+#include "utils.h"
+#include "router.h"
+#include "cpu_v1.h"
+#include "mem.h"
+#include "traffic.h"
+#include "stats.h"
+
+// Retea 2D de tip mesh R x C: fiecare router e legat N/S/E/V cu vecinii lui,
+// iar CPU-urile / memoriile se ataseaza pe portul local (L) al routerului.
+// Routerele folosesc rutare XY, deci id-ul unui periferic e xy_id(x, y) al routerului la care e atasat
+// si nu mai trebuie programata nicio tabela de rutare.
+SC_MODULE(Mesh) {
+    int rows, cols;
+    int fifo_depth;
+
+    std::vector<Router*> routers; // routers[y * cols + x]
+    std::vector<CPU*> cpus;
+    std::vector<MEM*> mems;
+    std::vector<TrafficGen*> traffic; // generatoarele de trafic sintetic (traffic.h)
+
+    std::vector<stat_fifo<packet>*> links;        // legaturile router-router (cate una pe fiecare sens)
+    std::vector<stat_fifo<packet>*> periph_links; // legaturile catre periferice
+    std::vector<sc_fifo<packet>*> dummy_fifos;    // porturile inchise
+    std::vector<sc_fifo<cfg_trans>*> cfg_fifos; // cate un canal de configurare pentru fiecare router
+
+    std::vector<bool> local_used; // portul local al routerului (x, y) are deja un periferic?
+
+    Router* at(int x, int y) { return routers[y * cols + x]; }
+
+    // Canalul de configurare al routerului (x, y), pentru cfg_trans la runtime
+    sc_fifo<cfg_trans>& cfg(int x, int y) { return *cfg_fifos[y * cols + x]; }
+
+    SC_HAS_PROCESS(Mesh);
+
+    Mesh(sc_module_name name, int r, int c, int depth = 16)
+        : sc_module(name), rows(r), cols(c), fifo_depth(depth), local_used(r * c, false)
+    {
+        // Instantierea routerelor
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                std::string rname = "Router_" + std::to_string(x) + "_" + std::to_string(y);
+                Router* rt = new Router(rname.c_str());
+                rt->routing_mode = ROUTE_XY;
+                rt->my_x = x;
+                rt->my_y = y;
+
+                sc_fifo<cfg_trans>* f_cfg = new sc_fifo<cfg_trans>(16);
+                rt->cfg_port(*f_cfg);
+                cfg_fifos.push_back(f_cfg);
+
+                routers.push_back(rt);
+            }
+        }
+
+        // Legaturi orizontale: (x, y) Est <-> (x+1, y) Vest
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x + 1 < cols; x++) {
+                connect(at(x, y), E, at(x + 1, y), V);
+            }
+        }
+
+        // Legaturi verticale: (x, y) Sud <-> (x, y+1) Nord
+        for (int y = 0; y + 1 < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                connect(at(x, y), S, at(x, y + 1), N);
+            }
+        }
+
+        // Porturile de pe margine nu au vecin, le inchidem
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                if (y == 0)        close_port(at(x, y), N);
+                if (y == rows - 1) close_port(at(x, y), S);
+                if (x == cols - 1) close_port(at(x, y), E);
+                if (x == 0)        close_port(at(x, y), V);
+            }
+        }
+    }
+
+    // Ataseaza un CPU pe portul local al routerului (x, y); id-ul lui va fi xy_id(x, y)
+    CPU* attach_cpu(int x, int y, int target, int addr, int data) {
+        int id = xy_id(x, y);
+        CPU* c = new CPU(("CPU_" + std::to_string(x) + "_" + std::to_string(y)).c_str(), id, target, addr, data);
+        cpus.push_back(c);
+
+        // Firul 1: CPU -> Router (Request)
+        stat_fifo<packet>* f_req = new stat_fifo<packet>((std::string(c->basename()) + "_req").c_str(), fifo_depth);
+        c->out_port(*f_req);
+        at(x, y)->in_ports[L](*f_req);
+        periph_links.push_back(f_req);
+
+        // Firul 2: Router -> CPU (Response)
+        stat_fifo<packet>* f_rsp = new stat_fifo<packet>((std::string(c->basename()) + "_rsp").c_str(), fifo_depth);
+        at(x, y)->out_ports[L](*f_rsp);
+        c->in_port(*f_rsp);
+        periph_links.push_back(f_rsp);
+
+        local_used[y * cols + x] = true;
+        return c;
+    }
+
+    // Ataseaza o memorie pe portul local al routerului (x, y); id-ul ei va fi xy_id(x, y)
+    MEM* attach_mem(int x, int y) {
+        int id = xy_id(x, y);
+        MEM* m = new MEM(("MEM_" + std::to_string(x) + "_" + std::to_string(y)).c_str(), id);
+        mems.push_back(m);
+
+        // Firul 1: Router -> MEM (Request)
+        stat_fifo<packet>* f_req = new stat_fifo<packet>((std::string(m->basename()) + "_req").c_str(), fifo_depth);
+        at(x, y)->out_ports[L](*f_req);
+        m->in_port(*f_req);
+        periph_links.push_back(f_req);
+
+        // Firul 2: MEM -> Router (Response)
+        stat_fifo<packet>* f_rsp = new stat_fifo<packet>((std::string(m->basename()) + "_rsp").c_str(), fifo_depth);
+        m->out_port(*f_rsp);
+        at(x, y)->in_ports[L](*f_rsp);
+        periph_links.push_back(f_rsp);
+
+        local_used[y * cols + x] = true;
+        return m;
+    }
+
+    // Ataseaza un generator de trafic sintetic pe portul local al routerului (x, y); id-ul lui va fi xy_id(x, y)
+    TrafficGen* attach_traffic(int x, int y, const TrafficConfig& tcfg) {
+        int id = xy_id(x, y);
+        TrafficGen* t = new TrafficGen(("TG_" + std::to_string(x) + "_" + std::to_string(y)).c_str(), id, rows, cols, tcfg);
+        traffic.push_back(t);
+
+        // Firul 1: generator -> Router (injectie)
+        stat_fifo<packet>* f_inj = new stat_fifo<packet>((std::string(t->basename()) + "_inj").c_str(), fifo_depth);
+        t->out_port(*f_inj);
+        at(x, y)->in_ports[L](*f_inj);
+        periph_links.push_back(f_inj);
+
+        // Firul 2: Router -> generator (ejectie)
+        stat_fifo<packet>* f_ej = new stat_fifo<packet>((std::string(t->basename()) + "_ej").c_str(), fifo_depth);
+        at(x, y)->out_ports[L](*f_ej);
+        t->in_port(*f_ej);
+        periph_links.push_back(f_ej);
+
+        local_used[y * cols + x] = true;
+        return t;
+    }
+
+    // Cate un generator pe fiecare router din mesh
+    void attach_traffic_all(const TrafficConfig& tcfg) {
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) attach_traffic(x, y, tcfg);
+        }
+    }
+
+    // Statisticile tuturor routerelor si legaturilor (router-router + periferice), in CSV si JSON
+    void dump_stats(const std::string& prefix) {
+        std::vector<stat_fifo<packet>*> all(links);
+        all.insert(all.end(), periph_links.begin(), periph_links.end());
+        ::dump_stats(prefix, routers, all, routers[0]->cycle_time);
+    }
+
+    // Perifericele se ataseaza dupa constructor, deci porturile locale ramase libere le inchidem
+    // abia inainte de finalul elaborarii (ultimul moment in care SystemC ne lasa sa legam porturi)
+    void before_end_of_elaboration() {
+        for (int i = 0; i < rows * cols; i++) {
+            if (!local_used[i]) {
+                close_port(routers[i], L);
+                local_used[i] = true;
+            }
+        }
+    }
+
+private:
+    // Leaga doua routere vecine in ambele sensuri: a.out[pa] -> b.in[pb] si b.out[pb] -> a.in[pa]
+    void connect(Router* a, int pa, Router* b, int pb) {
+        stat_fifo<packet>* ab = new stat_fifo<packet>(link_name(a, pa).c_str(), fifo_depth);
+        stat_fifo<packet>* ba = new stat_fifo<packet>(link_name(b, pb).c_str(), fifo_depth);
+        a->out_ports[pa](*ab);
+        b->in_ports[pb](*ab);
+        b->out_ports[pb](*ba);
+        a->in_ports[pa](*ba);
+        links.push_back(ab);
+        links.push_back(ba);
+    }
+
+    // Numele legaturii dupa routerul si portul de iesire care o alimenteaza (ex: link_Router_2_3_EST)
+    std::string link_name(Router* from, int port) {
+        return std::string("link_") + from->basename() + "_" + PortNames[port];
+    }
+
+    // Închide un port (conectează la nimic/dummy) si il dezactiveaza, ca un pachet cu destinatie
+    // in afara mesh-ului sa fie aruncat (DROP) in loc sa umple FIFO-ul dummy si sa blocheze routerul
+    void close_port(Router* rt, int port) {
+        rt->port_enabled[port] = false;
+        sc_fifo<packet>* d1 = new sc_fifo<packet>(1);
+        sc_fifo<packet>* d2 = new sc_fifo<packet>(1);
+        rt->in_ports[port](*d1);
+        rt->out_ports[port](*d2);
+        dummy_fifos.push_back(d1);
+        dummy_fifos.push_back(d2);
+    }
+};
+
+#endif
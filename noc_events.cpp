@@ -0,0 +1,237 @@
+// Analiza offline a evenimentelor inregistrate cu NOC_EVENTS (L1) / events= (L2_traffic), vezi event_log.h.
+// Nu are nevoie de SystemC:
+//   g++ -O2 -o noc_events noc_events.cpp
+//   ./noc_events <fisier> [paths=5] [top=10] [csv=<prefix>]
+// Afiseaza: cate evenimente de fiecare tip, utilizarea legaturilor (flit-uri scrise pe fiecare iesire / ciclu),
+// drumul fiecarui pachet reconstruit din evenimente (primele `paths` si cel mai lent) si unde isi petrec pachetele
+// livrate timpul in retea, de la intrare (INJECT) la iesire (EJECT): in cozile routerelor (de la FORWARD pana la ARB-ul
+// urmatorului router) si blocate dupa arbitrare (de la ARB pana la FORWARD, iesirea plina).
+// Separat: cat au asteptat cererile la sursa (inject_time -> INJECT). Raspunsurile mostenesc inject_time-ul cererii
+// (mem.h), deci la ele diferenta e varsta tranzactiei cand raspunsul intra in retea (drumul cererii + MEM).
+// Cu csv=<prefix> scrie si <prefix>_links.csv si <prefix>_packets.csv.
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "noc_types.h"
+#include "event_log.h"
+
+using namespace std;
+
+const char* TypeNames[] = { "WRITE", "READ", "ACK", "DATA" };
+
+// Un pachet = evenimentele flit-ului HEAD / SINGLE cu acelasi antet
+typedef tuple<int32_t, uint64_t, uint8_t, int32_t, int32_t> PacketKey; // src, inject, type, tag, address
+
+struct PacketPath {
+    vector<const noc_event*> ev;
+    bool delivered, dropped;
+    double injected;                  // ciclul INJECT (sau primul ARB, daca inregistrarea a pornit cu pachetul in retea)
+    double latency, queueing, blocked; // cicluri in retea: latency = queueing + blocked
+    double before;                     // inject_time -> injected: asteptare la sursa (cereri) / varsta tranzactiei (raspunsuri)
+    int routers;
+};
+
+static const char* port_name(uint8_t p) { return (p < NUM_PORTS) ? PortNames[p] : "-"; }
+
+static const char* type_name(uint8_t t) { return (t < 4) ? TypeNames[t] : "?"; }
+
+// packet::RSP_ACK = 2, RSP_DATA = 3: pastreaza inject_time-ul cererii
+static bool is_response(uint8_t t) { return t >= 2; }
+
+static void print_path(const EventFile& f, const PacketPath& p) {
+    const noc_event& h = *p.ev[0];
+    cout << "  " << type_name(h.type) << " " << h.src_id << " -> " << h.dst_id << " addr " << h.address << " tag " << h.tag
+         << ", injected @" << p.injected << (is_response(h.type) ? ", transaction age " : ", source wait ") << p.before;
+    if (p.delivered) cout << ", latency " << p.latency << " cycles";
+    else cout << (p.dropped ? ", DROPPED" : ", in flight");
+    cout << endl;
+    for (size_t i = 0; i < p.ev.size(); i++) {
+        const noc_event& e = *p.ev[i];
+        if (e.kind == EV_INJECT) continue;
+        cout << "    @" << setw(8) << left << e.time / f.cycle << right << setw(8) << EventKindNames[e.kind] << "  "
+             << f.router_name(e.router) << " " << port_name(e.in_port) << " -> " << port_name(e.out_port) << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: " << argv[0] << " <events file> [paths=5] [top=10] [csv=<prefix>]" << endl;
+        return 1;
+    }
+    int show_paths = 5;
+    int top = 10;
+    string csv;
+    for (int i = 2; i < argc; i++) {
+        const char* eq = strchr(argv[i], '=');
+        if (eq == NULL) {
+            cout << "Bad argument '" << argv[i] << "' (expected key=value)" << endl;
+            return 1;
+        }
+        string key(argv[i], eq - argv[i]);
+        const char* val = eq + 1;
+        if (key == "paths") show_paths = atoi(val);
+        else if (key == "top") top = atoi(val);
+        else if (key == "csv") csv = val;
+        else {
+            cout << "Unknown parameter '" << key << "'" << endl;
+            return 1;
+        }
+    }
+
+    EventFile f;
+    if (!f.load(argv[1])) {
+        cout << "ERROR: " << f.error << endl;
+        return 1;
+    }
+    if (f.cycle == 0) f.cycle = 1;
+    if (f.events.empty()) {
+        cout << "No events in " << argv[1] << endl;
+        return 0;
+    }
+
+    // 1. Totaluri
+    uint64_t kinds[NUM_EVENT_KINDS] = { 0 };
+    uint64_t t_min = f.events[0].time, t_max = f.events[0].time;
+    int n_routers = (int)f.router_names.size();
+    for (const noc_event& e : f.events) {
+        if (e.kind < NUM_EVENT_KINDS) kinds[e.kind]++;
+        t_min = min(t_min, e.time);
+        t_max = max(t_max, e.time);
+        n_routers = max(n_routers, (int)e.router + 1);
+    }
+    double span = (double)(t_max - t_min) / f.cycle + 1;
+
+    cout << fixed << setprecision(2);
+    cout << "--- EVENTS: " << f.events.size() << " from " << n_routers << " routers, cycles " << t_min / f.cycle << " .. "
+         << t_max / f.cycle << " ---" << endl;
+    for (int k = 0; k < NUM_EVENT_KINDS; k++) cout << setw(10) << EventKindNames[k] << setw(12) << kinds[k] << endl;
+
+    // 2. Utilizarea legaturilor: flit-uri scrise pe fiecare iesire, raportat la durata inregistrarii
+    vector<uint64_t> link_flits(n_routers * NUM_PORTS, 0);
+    for (const noc_event& e : f.events) {
+        if (e.kind == EV_FORWARD && e.out_port < NUM_PORTS) link_flits[e.router * NUM_PORTS + e.out_port]++;
+    }
+    vector<int> links;
+    for (int i = 0; i < (int)link_flits.size(); i++) {
+        if (link_flits[i] > 0) links.push_back(i);
+    }
+    sort(links.begin(), links.end(), [&](int a, int b) { return link_flits[a] > link_flits[b]; });
+    cout << endl << "--- BUSIEST LINKS (flits / cycle over " << (uint64_t)span << " cycles) ---" << endl;
+    for (int i = 0; i < (int)links.size() && i < top; i++) {
+        cout << "  " << setw(24) << left << f.router_name(links[i] / NUM_PORTS) << right << setw(6)
+             << port_name(links[i] % NUM_PORTS) << setw(10) << link_flits[links[i]] << setw(8) << link_flits[links[i]] / span << endl;
+    }
+
+    // 3. Drumurile pachetelor
+    map<PacketKey, PacketPath> packets;
+    for (const noc_event& e : f.events) {
+        if (e.flit > 1) continue; // packet::FLIT_SINGLE = 0, FLIT_HEAD = 1
+        packets[PacketKey(e.src_id, e.inject, e.type, e.tag, e.address)].ev.push_back(&e);
+    }
+
+    uint64_t delivered = 0, dropped = 0, in_flight = 0, requests = 0, responses = 0;
+    double sum_lat = 0, sum_queue = 0, sum_blocked = 0, sum_routers = 0, sum_source = 0, sum_age = 0;
+    const PacketPath* slowest = NULL;
+    vector<const PacketPath*> order; // in ordinea intrarii in retea, pentru paths= si CSV
+    for (auto& kv : packets) {
+        PacketPath& p = kv.second;
+        // La acelasi moment, in acelasi router: INJECT < ARB < FORWARD < DROP < EJECT (ordinea din enum)
+        sort(p.ev.begin(), p.ev.end(), [](const noc_event* a, const noc_event* b) {
+            return (a->time != b->time) ? a->time < b->time : a->kind < b->kind;
+        });
+        p.delivered = p.dropped = false;
+        p.latency = p.queueing = p.blocked = 0;
+        p.routers = 0;
+        p.injected = (double)p.ev[0]->time / f.cycle; // dupa sortare, INJECT / primul ARB e primul
+        p.before = p.injected - (double)p.ev[0]->inject / f.cycle;
+        double last_forward = -1, last_arb = -1;
+        for (const noc_event* e : p.ev) {
+            double t = (double)e->time / f.cycle;
+            if (e->kind == EV_ARB) {
+                if (last_forward >= 0) p.queueing += t - last_forward;
+                last_arb = t;
+                p.routers++;
+            } else if (e->kind == EV_FORWARD) {
+                if (last_arb >= 0) p.blocked += t - last_arb;
+                last_forward = t;
+            } else if (e->kind == EV_EJECT) {
+                p.delivered = true;
+                p.latency = t - p.injected;
+            } else if (e->kind == EV_DROP) {
+                p.dropped = true;
+            }
+        }
+        if (p.delivered) {
+            delivered++;
+            sum_lat += p.latency;
+            sum_queue += p.queueing;
+            sum_blocked += p.blocked;
+            sum_routers += p.routers;
+            if (is_response(p.ev[0]->type)) {
+                responses++;
+                sum_age += p.before;
+            } else {
+                requests++;
+                sum_source += p.before;
+            }
+            if (slowest == NULL || p.latency > slowest->latency) slowest = &p;
+        } else if (p.dropped) {
+            dropped++;
+        } else {
+            in_flight++;
+        }
+        order.push_back(&p);
+    }
+    sort(order.begin(), order.end(), [](const PacketPath* a, const PacketPath* b) {
+        return (a->ev[0]->time != b->ev[0]->time) ? a->ev[0]->time < b->ev[0]->time : a->ev[0]->inject < b->ev[0]->inject;
+    });
+
+    cout << endl << "--- PACKETS: " << packets.size() << " (delivered " << delivered << ", dropped " << dropped
+         << ", in flight " << in_flight << ") ---" << endl;
+    if (delivered > 0) {
+        double n = (double)delivered;
+        cout << "Avg network latency " << sum_lat / n << " cycles = queueing " << sum_queue / n << " + blocked "
+             << sum_blocked / n << " | Avg routers " << sum_routers / n << endl;
+        if (requests > 0) cout << "Avg source wait (requests, inject_time -> INJECT) " << sum_source / requests << " cycles" << endl;
+        if (responses > 0) cout << "Avg transaction age at injection (responses) " << sum_age / responses << " cycles" << endl;
+    }
+    for (int i = 0; i < (int)order.size() && i < show_paths; i++) print_path(f, *order[i]);
+    if (slowest != NULL && show_paths > 0) {
+        cout << "Slowest:" << endl;
+        print_path(f, *slowest);
+    }
+
+    // 4. CSV
+    if (!csv.empty()) {
+        ofstream lf(csv + "_links.csv");
+        lf << "router,port,flits,flits_per_cycle\n";
+        for (int i : links) {
+            lf << f.router_name(i / NUM_PORTS) << "," << port_name(i % NUM_PORTS) << "," << link_flits[i] << ","
+               << link_flits[i] / span << "\n";
+        }
+        ofstream pf(csv + "_packets.csv");
+        pf << "src,dst,type,address,tag,inject_time,injected,status,latency,queueing,blocked,routers,source_wait,age\n";
+        pf << fixed << setprecision(2);
+        for (const PacketPath* p : order) {
+            const noc_event& h = *p->ev[0];
+            pf << h.src_id << "," << h.dst_id << "," << type_name(h.type) << "," << h.address << "," << h.tag << ","
+               << h.inject / f.cycle << "," << p->injected << "," << (p->delivered ? "delivered" : p->dropped ? "dropped" : "in_flight")
+               << "," << p->latency << "," << p->queueing << "," << p->blocked << "," << p->routers << ",";
+            if (is_response(h.type)) pf << "," << p->before << "\n";
+            else pf << p->before << ",\n";
+        }
+        if (!lf || !pf) {
+            cout << "ERROR: writing " << csv << "_*.csv failed" << endl;
+            return 1;
+        }
+        cout << "CSV: " << csv << "_links.csv, " << csv << "_packets.csv" << endl;
+    }
+    return 0;
+}
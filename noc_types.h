@@ -0,0 +1,167 @@
+// noc_types.h
+#ifndef NOC_TYPES_H
+#define NOC_TYPES_H
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Tipurile comune care nu depind de SystemC (porturi, moduri, id-uri, config), ca sa poata fi folosite
+// si de motoarele / benchmark-urile fara kernel SystemC (vezi cycle_engine.h). utils.h le include.
+
+enum PortID { N = 0, S = 1, E = 2, V = 3, L = 4 }; // L = portul local (CPU/MEM atasat direct routerului)
+const int NUM_PORTS = 5;
+enum ArbMode { PRIORITY = 0, ROUND_ROBIN = 1, OLDEST_FIRST = 2, WEIGHTED_RR = 3 };
+const char* ArbModeNames[] = { "Fixed Priority", "Round-Robin", "Oldest-First", "Weighted Round-Robin" };
+enum RouteMode { ROUTE_TABLE = 0, ROUTE_XY = 1, ROUTE_WEST_FIRST = 2, ROUTE_ODD_EVEN = 3 }; // ultimele doua: adaptiv minim in mesh
+const char* RouteModeNames[] = { "Table", "XY", "West-first", "Odd-even" };
+enum SwitchMode { SWITCH_SINGLE = 0, SWITCH_CROSSBAR = 1 }; // cate pachete muta Router intr-un ciclu (vezi SET_SWITCH)
+const char* PortNames[] = { "NORD", "SUD", "EST", "VEST", "LOCAL" };
+
+// In mesh, id-urile sunt codificate pe coordonate: (y << 8) | x  (maxim 256 x 256 routere)
+inline int xy_id(int x, int y) { return (y << 8) | x; }
+inline int id_x(int id) { return id & 0xFF; }
+inline int id_y(int id) { return id >> 8; }
+
+// De unde incepe arbitrul sa caute o intrare (ultima servita = last): PRIORITY de la 0, ROUND_ROBIN dupa ultima
+// servita, WEIGHTED_RR ramane pe ultima servita cat timp mai are grant-uri in runda ei (left > 0).
+// OLDEST_FIRST compara varsta pachetelor (inject_time); ordinea de aici decide doar egalitatile (ca la ROUND_ROBIN).
+inline int arb_start(int policy, int last, int left) {
+    if (policy == PRIORITY) return 0;
+    if (policy == WEIGHTED_RR && left > 0) return last;
+    return (last + 1) % NUM_PORTS;
+}
+
+// WEIGHTED_RR: cate grant-uri consecutive ii mai raman intrarii in dupa ce a castigat (weight[in] pe runda)
+inline int arb_left_after(int policy, int in, int last, int left, const int weight[]) {
+    if (policy != WEIGHTED_RR) return 0;
+    return (in == last && left > 0) ? left - 1 : weight[in] - 1;
+}
+
+// Rutare dimension-order XY: intai corectam X (Est/Vest), apoi Y (Nord/Sud), apoi iesim pe portul local.
+// In mesh, Nord = y-1 si Sud = y+1 (randul 0 e sus).
+inline int xy_route_port(int my_x, int my_y, int dst_id) {
+    int dx = id_x(dst_id) - my_x;
+    int dy = id_y(dst_id) - my_y;
+    if (dx > 0) return E;
+    if (dx < 0) return V;
+    if (dy > 0) return S;
+    if (dy < 0) return N;
+    return L;
+}
+
+// Ca xy_route_port, dar intr-un tor cu legaturi wraparound: pe fiecare dimensiune cu inel (ring_cols / ring_rows > 0)
+// pleaca pe sensul mai scurt. La egalitate (jumatate de inel) merge in sensul pozitiv (E / S), deci ruta e fixa.
+// ring_* = 0 inseamna ca dimensiunea nu se inchide (ca in mesh).
+inline int torus_route_port(int my_x, int my_y, int dst_id, int ring_cols, int ring_rows) {
+    int dx = id_x(dst_id) - my_x;
+    int dy = id_y(dst_id) - my_y;
+    if (ring_cols > 0) {
+        dx = (dx % ring_cols + ring_cols) % ring_cols;
+        if (dx > ring_cols / 2) dx -= ring_cols;
+    }
+    if (ring_rows > 0) {
+        dy = (dy % ring_rows + ring_rows) % ring_rows;
+        if (dy > ring_rows / 2) dy -= ring_rows;
+    }
+    if (dx > 0) return E;
+    if (dx < 0) return V;
+    if (dy > 0) return S;
+    if (dy < 0) return N;
+    return L;
+}
+
+// Rutare minima adaptiva in mesh: iesirile productive (care apropie pachetul de destinatie) permise de modelul
+// de viraje, in ordinea preferata la egalitate (intai X, ca XY). Returneaza cate iesiri a scris in ports[] (cel
+// mult 2); 0 = suntem pe routerul destinatie (portul L). Modelul de viraje interzice destule viraje cat sa nu
+// existe cicluri de dependenta intre legaturi, deci alegerea dupa aglomerare nu poate crea deadlock.
+
+// West-first: daca destinatia e la vest mergem intai numai spre vest (V), deterministic; spre est/nord/sud
+// alegem liber, pentru ca nu mai avem voie sa virim spre vest mai tarziu.
+inline int west_first_ports(int my_x, int my_y, int dst_id, int ports[2]) {
+    int dx = id_x(dst_id) - my_x;
+    int dy = id_y(dst_id) - my_y;
+    int n = 0;
+    if (dx < 0) {
+        ports[n++] = V;
+        return n;
+    }
+    if (dx > 0) ports[n++] = E;
+    if (dy > 0) ports[n++] = S;
+    if (dy < 0) ports[n++] = N;
+    return n;
+}
+
+// Odd-even (Chiu): nu virim din est spre nord/sud in coloanele pare si nu virim din nord/sud spre vest in
+// coloanele impare. Spre deosebire de west-first, lasa alegere si pachetelor care merg spre vest.
+// Are nevoie de coloana sursei (src_id, codificat cu xy_id).
+inline int odd_even_ports(int my_x, int my_y, int src_id, int dst_id, int ports[2]) {
+    int dx = id_x(dst_id) - my_x;
+    int dy = id_y(dst_id) - my_y;
+    int vertical = (dy > 0) ? S : N;
+    int n = 0;
+    if (dx == 0) {
+        if (dy != 0) ports[n++] = vertical;
+        return n;
+    }
+    if (dx > 0) {
+        if (dy == 0) {
+            ports[n++] = E;
+            return n;
+        }
+        // putem vira spre nord/sud doar intr-o coloana impara sau in coloana sursei (am intrat din L, nu din vest)
+        bool can_turn = (my_x % 2 == 1) || my_x == id_x(src_id);
+        // mergem mai departe spre est doar daca nu ajungem astfel intr-o coloana para unde nu mai avem voie sa virim
+        bool can_east = (id_x(dst_id) % 2 == 1) || dx != 1;
+        if (can_east || !can_turn) ports[n++] = E; // !can_turn && !can_east nu apare pe un drum odd-even, dar nu lasam pachetul fara iesire
+        if (can_turn) ports[n++] = vertical;
+        return n;
+    }
+    ports[n++] = V;
+    if (dy != 0 && my_x % 2 == 0) ports[n++] = vertical;
+    return n;
+}
+
+// Structura pentru tranzactii de configurare (deci practic cu acesta ii spunem routerului ce sa faca)
+struct cfg_trans {
+    // AM ADAUGAT INAPOI SET_ARBITER
+    enum Type { SET_ROUTE = 0, ENABLE_PORT = 1, SET_Q_LEN = 2, SET_ARBITER = 3, SET_ROUTE_RANGE = 4, LOAD_TABLE = 5, SET_ROUTING = 6, SET_SWITCH = 7,
+                SET_ARB_WEIGHT = 8 };
+    // SET_ROUTE: comanda de schimbare a tabelei de rutare
+    // ENABLE_PORT: comanda de activare/dezactivare port
+    // SET_Q_LEN: comanda de setare lungime coada (target = intrarea routerului, value = noua capacitate a FIFO-ului ei)
+    // SET_ARBITER: comanda de schimbare a regulii de prioritate
+    // SET_ROUTE_RANGE: aceeasi iesire pentru toate destinatiile din [target, aux] (o singura tranzactie)
+    // LOAD_TABLE: incarca o tabela intreaga: table[i] = port pentru destinatia target + i
+    // SET_ROUTING: modul de rutare (value: ROUTE_TABLE sau ROUTE_XY)
+    // SET_SWITCH: cate pachete pe ciclu (value: SWITCH_SINGLE sau SWITCH_CROSSBAR)
+    // SET_ARB_WEIGHT: ponderea intrarii target pentru WEIGHTED_RR (value = grant-uri consecutive pe runda, >= 1)
+
+    int type; //Tipul comenzii
+    int target; //Pt SET_ROUTE: adresa destinatar; Pt ENABLE_PORT / SET_Q_LEN: id port; Pt SET_ROUTE_RANGE/LOAD_TABLE: primul id
+    int value;  //Pt SET_ROUTE: id port de iesire; Pt SET_ARBITER: 0=FixPriority, 1=RR, 2=OldestFirst, 3=WRR
+    int aux;    //Pt SET_ROUTE_RANGE: ultimul id din interval (inclusiv)
+    std::shared_ptr<const std::vector<int8_t> > table; //Pt LOAD_TABLE (partajata, ca sa nu copiem tabela prin FIFO)
+
+    cfg_trans() : type(0), target(0), value(0), aux(0) {}
+
+    cfg_trans(int t, int tg, int v) : type(t), target(tg), value(v), aux(0) {}
+
+    cfg_trans(int t, int tg, int v, int a) : type(t), target(tg), value(v), aux(a) {}
+
+    cfg_trans(int t, int tg, std::shared_ptr<const std::vector<int8_t> > tbl)
+        : type(t), target(tg), value(0), aux(0), table(tbl) {}
+
+    bool operator==(const cfg_trans& other) const {
+        return (type == other.type && target == other.target && value == other.value &&
+                aux == other.aux && table == other.table);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const cfg_trans& t) {
+        os << "{CFG Type:" << t.type << " Tgt:" << t.target << " Val:" << t.value << " Aux:" << t.aux << "}";
+        return os;
+    }
+};
+
+#endif
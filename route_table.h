@@ -0,0 +1,71 @@
+// route_table.h
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include <vector>
+#include <cstdint>
+#include "noc_types.h"
+
+// Tabela de rutare densa: un vector indexat direct cu dst_id, fiecare intrare = portul de iesire.
+// Inlocuieste std::map<int,int> din Router: un lookup e un singur acces in memorie (O(1)),
+// iar toata tabela sta contiguu (1 octet pe destinatie).
+// Nu depinde de SystemC, ca sa poata fi folosita si in benchmark-uri / alte motoare de simulare.
+class RouteTable {
+public:
+    static const int NO_ROUTE = -1;
+    static const int MAX_ID = 1 << 16; // spatiul de id-uri e marginit: [0, MAX_ID)
+
+    // Portul de iesire pentru dst, sau NO_ROUTE daca nu exista ruta
+    int lookup(int dst) const {
+        return ((unsigned)dst < ports.size()) ? ports[dst] : NO_ROUTE;
+    }
+
+    bool has_route(int dst) const { return lookup(dst) != NO_ROUTE; }
+
+    // Un port de iesire pe care il putem pune in tabela: [0, NUM_PORTS) sau NO_ROUTE (sterge ruta)
+    static bool valid_port(int port) { return port == NO_ROUTE || (port >= 0 && port < NUM_PORTS); }
+
+    // Seteaza ruta pentru o singura destinatie. Intoarce false daca id-ul e in afara spatiului sau portul nu exista.
+    bool set(int dst, int port) {
+        return set_range(dst, dst, port);
+    }
+
+    // Seteaza aceeasi iesire pentru toate destinatiile din [lo, hi] (inclusiv)
+    bool set_range(int lo, int hi, int port) {
+        if (lo < 0 || hi < lo || hi >= MAX_ID || !valid_port(port)) return false;
+        grow(hi + 1);
+        for (int d = lo; d <= hi; d++) ports[d] = (int8_t)port;
+        return true;
+    }
+
+    // Incarca o tabela intreaga: table[i] = portul pentru destinatia base + i (NO_ROUTE = sarim).
+    // O tabela cu un port care nu exista e refuzata in intregime, fara sa schimbe nimic.
+    bool load(const std::vector<int8_t>& table, int base) {
+        if (base < 0 || base + (long)table.size() > MAX_ID) return false;
+        for (size_t i = 0; i < table.size(); i++) {
+            if (!valid_port(table[i])) return false;
+        }
+        grow(base + (int)table.size());
+        for (size_t i = 0; i < table.size(); i++) {
+            if (table[i] != NO_ROUTE) ports[base + i] = table[i];
+        }
+        return true;
+    }
+
+    void clear() { ports.clear(); }
+
+    // Numarul de intrari alocate (cel mai mare dst_id configurat + 1)
+    int size() const { return (int)ports.size(); }
+
+    // Toate intrarile (ports[dst_id]), ca sa poata fi salvate si reincarcate cu load(entries(), 0)
+    const std::vector<int8_t>& entries() const { return ports; }
+
+private:
+    void grow(int n) {
+        if ((int)ports.size() < n) ports.resize(n, (int8_t)NO_ROUTE);
+    }
+
+    std::vector<int8_t> ports; // ports[dst_id] = port de iesire (-1 = fara ruta)
+};
+
+#endif
@@ -4,102 +4,742 @@
 
 #include <systemc.h>
 #include "utils.h"
-#include <map>
+#include "log.h"
+#include "route_table.h"
+#include "stats.h"
+#include "checkpoint.h"
+#include <cmath>
+#include <algorithm>
+
+// Numele portului din SET_ROUTE / SET_ROUTE_RANGE (NO_ROUTE = ruta stearsa)
+inline const char* route_port_name(int port) { return (port == RouteTable::NO_ROUTE) ? "none" : PortNames[port]; }
+
+// Comenzile de configurare comune pentru toate tipurile de router (Router, VCRouter):
+// R trebuie sa aiba routing_table, port_enabled[], routing_mode, arbitration_policy si arb_weight[]
+template <class R>
+void apply_router_config(R& r, const cfg_trans& c) {
+    switch (c.type) {
+        case cfg_trans::SET_ROUTE:
+            if (r.routing_table.set(c.target, c.value)) {
+                NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Route: Dst " << c.target << "->Port " << route_port_name(c.value) << endl);
+            } else if (!RouteTable::valid_port(c.value)) {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: invalid output port " << c.value << " for Dst " << c.target << endl);
+            } else {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: Dst " << c.target << " outside the routing table id space" << endl);
+            }
+            break;
+        case cfg_trans::SET_ROUTE_RANGE:
+            if (r.routing_table.set_range(c.target, c.aux, c.value)) {
+                NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Route: Dst " << c.target << ".." << c.aux << "->Port " << route_port_name(c.value) << endl);
+            } else if (!RouteTable::valid_port(c.value)) {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: invalid output port " << c.value << " for Dst " << c.target << ".." << c.aux << endl);
+            } else {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: invalid route range " << c.target << ".." << c.aux << endl);
+            }
+            break;
+        case cfg_trans::LOAD_TABLE:
+            if (c.table && r.routing_table.load(*c.table, c.target)) {
+                NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Route table loaded: " << c.table->size() << " entries from Dst " << c.target << endl);
+            } else {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: invalid route table (id range or output port)" << endl);
+            }
+            break;
+        case cfg_trans::ENABLE_PORT:
+            if (c.target < 0 || c.target >= NUM_PORTS) {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: invalid port " << c.target << endl);
+                break;
+            }
+            r.port_enabled[c.target] = (c.value != 0);
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Port " << c.target << (c.value ? " ON" : " OFF") << endl);
+            break;
+        case cfg_trans::SET_ROUTING:
+            if (c.value < ROUTE_TABLE || c.value > ROUTE_ODD_EVEN) {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: invalid routing mode " << c.value << endl);
+                break;
+            }
+            r.routing_mode = c.value;
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Routing mode: " << RouteModeNames[c.value] << endl);
+            break;
+        case cfg_trans::SET_ARBITER:
+            if (c.value < PRIORITY || c.value > WEIGHTED_RR) {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: invalid arbiter " << c.value << endl);
+                break;
+            }
+            r.arbitration_policy = c.value;
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Arbiter changed to: " << ArbModeNames[c.value] << endl);
+            break;
+        case cfg_trans::SET_ARB_WEIGHT:
+            if (c.target < 0 || c.target >= NUM_PORTS) {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: invalid arbiter weight port " << c.target << endl);
+                break;
+            }
+            r.arb_weight[c.target] = (c.value > 0) ? c.value : 1;
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Arbiter weight: Port " << PortNames[c.target] << " -> " << r.arb_weight[c.target] << endl);
+            break;
+    }
+}
 
 SC_MODULE(Router) {
     //Deci practic acestea sunt porturile de intrare/iesire ale routerului (sau drumurile in analogia cu traficul rutier)
-    sc_fifo_in<packet>  in_ports[4]; // 0=N, 1=S, 2=E, 3=V, intrarile de pachete
-    sc_fifo_out<packet> out_ports[4]; // iesirile de pachete
+    sc_fifo_in<packet>  in_ports[NUM_PORTS]; // 0=N, 1=S, 2=E, 3=V, 4=L (local: CPU/MEM atasat direct), intrarile de pachete
+    sc_fifo_out<packet> out_ports[NUM_PORTS]; // iesirile de pachete
+    // Reteaua virtuala de raspunsuri (optionala, pe fiecare port): unde sunt legate, RSP_ACK / RSP_DATA circula pe FIFO-uri
+    // separate de cereri, deci un raspuns nu mai poate ramane in spatele cererilor care il asteapta (protocol deadlock).
+    // Pe porturile nelegate in_ports / out_ports duc ambele clase (ex. la CPU / MEM, care trimit oricum o singura clasa pe sens).
+    sc_port<sc_fifo_in_if<packet>, 1, SC_ZERO_OR_MORE_BOUND>  rsp_in[NUM_PORTS];
+    sc_port<sc_fifo_out_if<packet>, 1, SC_ZERO_OR_MORE_BOUND> rsp_out[NUM_PORTS];
     sc_fifo_in<cfg_trans> cfg_port; // portul de configurare
 
-    std::map<int, int> routing_table; // tabela de rutare: asociaza destinatii cu porturi de iesire (ex: Dst 10 -> Port 0)
-    bool port_enabled[4]; // statusul porturilor: true = activat, false = dezactivat
+    RouteTable routing_table; // tabela de rutare: asociaza destinatii cu porturi de iesire (ex: Dst 10 -> Port 0)
+    bool port_enabled[NUM_PORTS]; // statusul porturilor: true = activat, false = dezactivat
 
-    int arbitration_policy; // 0 = Prioritate Fixa, 1 = Round Robin
+    int arbitration_policy; // PRIORITY, ROUND_ROBIN, OLDEST_FIRST (inject_time cel mai mic) sau WEIGHTED_RR
     int last_served_port;   // Tine minte ultimul port servit (pentru Round Robin)
+    int arb_weight[NUM_PORTS]; // WEIGHTED_RR: cate grant-uri consecutive primeste fiecare intrare pe runda (SET_ARB_WEIGHT)
+    int arb_left;              // WEIGHTED_RR: cate grant-uri mai are last_served_port in runda curenta
+
+    // Un lane e un FIFO de intrare sau de iesire: lane = port pentru in_ports / out_ports, NUM_PORTS + port pentru rsp_in / rsp_out.
+    // Registrele de mai jos (crossbar, wormhole) sunt pe lane, arbitrajul si statisticile raman pe portul fizic (lane % NUM_PORTS).
+    static const int NUM_LANES = 2 * NUM_PORTS;
+    bool msg_classes; // macar un port are reteaua de raspunsuri legata: routerul nu mai blocheaza pe o iesire plina
+                      // si raspunsurile castiga arbitrarea in fata cererilor (setat la end_of_elaboration)
+
+    int switch_mode; // SWITCH_SINGLE = un pachet pe ciclu (bucla originala), SWITCH_CROSSBAR = cate unul pe fiecare iesire
+    int last_granted[NUM_PORTS]; // crossbar: ultima intrare servita de fiecare iesire (Round Robin per iesire)
+    int grant_left[NUM_PORTS];   // crossbar + WEIGHTED_RR: grant-urile ramase pentru last_granted[out] in runda curenta
+
+    // Crossbar: sc_fifo nu are peek, asa ca pachetul din fata fiecarei intrari e tinut intr-un registru
+    packet in_head[NUM_LANES];
+    bool head_valid[NUM_LANES];
+
+    // Wormhole: o iesire ramane alocata unui pachet de la flit-ul HEAD pana trece TAIL-ul
+    static const int NO_WORM = -2;
+    int in_route[NUM_LANES];  // portul de iesire (sau decizia de DROP) luat pentru pachetul care trece acum prin intrare, NO_WORM = niciunul
+    int out_owner[NUM_LANES]; // lane-ul de intrare care detine lane-ul de iesire, -1 = liber
+
+    RouterStats stats; // contoare: forward per intrare/iesire, drop-uri, arbitrare, timp blocat
+
+    // Inregistrarea binara a evenimentelor (event_log.h), NULL = oprita. edge_port[] = porturile cu periferic, unde
+    // pachetele intra (INJECT) si ies (EJECT) din retea: implicit L, Network marcheaza porturile CPU-urilor si MEM-urilor.
+    EventRecorder::Ring* events;
+    bool edge_port[NUM_PORTS];
+
+    int routing_mode; // ROUTE_TABLE = cautare in routing_table, ROUTE_XY = calcul din coordonatele din dst_id,
+                      // ROUTE_WEST_FIRST / ROUTE_ODD_EVEN = minim adaptiv dupa ocupanta iesirilor (vezi adaptive_route)
+    int my_x, my_y;   // pozitia routerului in mesh (folosita de ROUTE_XY si de rutarea adaptiva)
+
+    sc_time cycle_time; // cat dureaza procesarea unui pachet (10 ns)
+
+    // Starile explicite ale motorului SC_METHOD. Varianta SC_THREAD le tine la zi doar ca sa poata fi salvate
+    // intr-un checkpoint (acolo pozitia in process() e pe stiva corutinei, care nu se poate salva).
+    enum EngineState {
+        ST_IDLE = 0,      // toate intrarile sunt goale, asteptam un data_written_event()
+        ST_ARBITRATE = 1, // avem de lucru, asteptam tick-ul de 10 ns ca sa arbitram si sa rutam
+        ST_BLOCKED = 2    // pachetul castigator asteapta loc in out_ports[blocked_port]
+    };
+    int engine_state;
+    sc_time t_ref;       // finalul ultimului ciclu; de aici se numara urmatorii 10 ns
+    sc_time next_tick;   // ST_ARBITRATE: momentul la care ruleaza urmatorul step()
+    packet blocked_pkt;  // pachetul care nu a incaput in iesire (ST_BLOCKED)
+    int blocked_port;    // lane-ul de iesire pe care asteptam (fara msg_classes e chiar portul)
+    int blocked_in;      // intrarea de pe care a venit blocked_pkt (pentru evenimentul FORWARD)
+    sc_time blocked_since; // de cand asteptam (pentru stats.blocked_time)
+
+    sc_time resume_at; // > 0: starea vine dintr-un checkpoint salvat la momentul asta, procesul continua de acolo
+
+    // Evenimentele care pot trezi routerul: o scriere pe oricare intrare sau pe portul de config
+    sc_event_or_list wake_events;
+    // Cand routerul nu blocheaza (crossbar / msg_classes) un pachet poate astepta o iesire plina, deci ne trezim si
+    // cand se elibereaza o iesire
+    sc_event_or_list xbar_wake_events;
+
+    void init_wake_events() {
+        for (int i = 0; i < NUM_LANES; i++) {
+            if (lane_bound(i)) wake_events |= lane_in(i)->data_written_event();
+        }
+        wake_events |= cfg_port->data_written_event();
+
+        xbar_wake_events |= wake_events;
+        for (int i = 0; i < NUM_LANES; i++) {
+            if (i < NUM_PORTS || rsp_out[i - NUM_PORTS].size() > 0) xbar_wake_events |= lane_out(i)->data_read_event();
+        }
+    }
+
+    const sc_event_or_list& sleep_events() const {
+        return nonblocking() ? xbar_wake_events : wake_events;
+    }
+
+    // Pachetele asteapta in registrul intrarii in loc sa blocheze procesul pe o iesire plina
+    bool nonblocking() const { return switch_mode == SWITCH_CROSSBAR || msg_classes; }
+
+    void end_of_elaboration() {
+        msg_classes = false;
+        for (int i = 0; i < NUM_PORTS; i++) {
+            if (rsp_in[i].size() > 0 || rsp_out[i].size() > 0) msg_classes = true;
+        }
+    }
+
+    // FIFO-urile din spatele unui lane (rsp_in / rsp_out doar daca sunt legate, vezi lane_bound / out_lane)
+    bool lane_bound(int lane) const { return lane < NUM_PORTS || rsp_in[lane - NUM_PORTS].size() > 0; }
+    sc_fifo_in_if<packet>* lane_in(int lane) {
+        return (lane < NUM_PORTS) ? in_ports[lane].operator->() : rsp_in[lane - NUM_PORTS].operator->();
+    }
+    sc_fifo_out_if<packet>* lane_out(int lane) {
+        return (lane < NUM_PORTS) ? out_ports[lane].operator->() : rsp_out[lane - NUM_PORTS].operator->();
+    }
+
+    // Lane-ul de iesire al pachetului p pe portul out: raspunsurile merg pe rsp_out daca portul il are
+    int out_lane(int out, const packet& p) const {
+        return (p.is_response() && rsp_out[out].size() > 0) ? NUM_PORTS + out : out;
+    }
+
+    // Avem ceva de facut in ciclul urmator? (config in asteptare sau pachet pe un port activ)
+    bool has_work() {
+        if (cfg_port.num_available() > 0) return true;
+        for (int i = 0; i < NUM_LANES; i++) {
+            if (!port_enabled[i % NUM_PORTS] || !lane_bound(i)) continue;
+            if (head_valid[i]) {
+                // un pachet care asteapta o iesire ocupata de alt pachet (wormhole) sau, in crossbar, o iesire plina
+                // nu e de lucru: ne trezeste coada celuilalt pachet / data_read_event
+                if (head_can_move(i)) return true;
+            } else if (lane_in(i)->num_available() > 0) {
+                return true;
+            }
+        }
+        return false;
+    }
 
     void process() {
+        if (resume_at > SC_ZERO_TIME) resume_thread();
+#ifdef ROUTER_POLLING
+        // Varianta veche: ne trezim la fiecare 10 ns si verificam toate porturile, chiar daca nu e nimic
+        engine_state = ST_ARBITRATE;
         while (true) {
-            wait(10, SC_NS); //Routerul practic nu e instantaneu. Îi ia 10 nanosecunde să proceseze un pachet.
+            next_tick = sc_time_stamp() + cycle_time;
+            wait(cycle_time); //Routerul practic nu e instantaneu. Îi ia 10 nanosecunde să proceseze un pachet.
+            step();
+        }
+#else
+        // Varianta event-driven: dormim pe data_written_event() cat timp toate intrarile sunt goale.
+        // Pastram grila de 10 ns a versiunii cu polling (relativ la finalul ultimului ciclu),
+        // astfel incat timestamp-urile din log sa fie identice.
+        init_wake_events();
 
-            // 1. VERIFICĂ CONFIGURAREA (Deci practic inainte de a procesa pachete, ne uitam daca avem noi comenzi de configurare)
-            cfg_trans cfg;
-            while (cfg_port.nb_read(cfg)) { //non-blocking read (daca nu e nimic de citit, trece mai departe)
-                handle_config(cfg); //caz in care ne ducem sa procesam comanda de configurare
+        if (resume_at == SC_ZERO_TIME) t_ref = sc_time_stamp(); // momentul de la care polling-ul ar fi numarat urmatorii 10 ns
+
+        while (true) {
+            if (has_work()) {
+                engine_state = ST_ARBITRATE;
+                next_tick = sc_time_stamp() + cycle_time;
+                wait(cycle_time);
+            } else {
+                engine_state = ST_IDLE;
+                do {
+                    wait(sleep_events());
+                } while (!has_work());
+
+                engine_state = ST_ARBITRATE;
+                next_tick = sc_time_stamp() + time_to_next_tick();
+                wait(next_tick - sc_time_stamp());
             }
 
-            // 2. ARBITRARE SI SELECTIE PORT
-            // Aici decidem de la care port incepem sa verificam
-            int start_idx = 0;
+            step();
+            t_ref = sc_time_stamp(); // out_ports[].write() poate bloca, deci grila se muta ca la polling
+        }
+#endif
+    }
+
+    // Reluare dintr-un checkpoint (SC_THREAD): asteptam momentul salvat si terminam ce facea procesul atunci.
+    // Dupa asta process() intra in bucla lui ca dupa un step() obisnuit (ST_IDLE: intrarile erau goale).
+    void resume_thread() {
+        wait(resume_at);
+        if (engine_state == ST_BLOCKED) {
+            lane_out(blocked_port)->write(blocked_pkt);
+            stats.blocked_time += sc_time_stamp() - blocked_since;
+            record_forward(events, edge_port, blocked_in, blocked_port % NUM_PORTS, blocked_pkt);
+            NOC_LOG(LOG_TRACE, " -> Fwd to Port " << PortNames[blocked_port % NUM_PORTS] << endl);
+            engine_state = ST_ARBITRATE;
+            t_ref = sc_time_stamp();
+        } else if (engine_state == ST_ARBITRATE) {
+            if (next_tick > sc_time_stamp()) wait(next_tick - sc_time_stamp());
+            step();
+            t_ref = sc_time_stamp();
+        }
+    }
 
-            if (arbitration_policy == PRIORITY) {
-                start_idx = 0; // In mod PRIORITATE, incepem mereu de la 0 (Nord)
-            } else {
-                // In mod ROUND ROBIN, incepem de la urmatorul dupa cel servit ultima data
-                start_idx = (last_served_port + 1) % 4; 
+    // Polling-ul ar fi vazut pachetul abia la primul tick de dupa scriere (t_ref + k*10 ns, strict mai mare),
+    // pentru ca o scriere in sc_fifo devine vizibila doar dupa faza de update
+    sc_time time_to_next_tick() {
+        double ticks = floor((sc_time_stamp() - t_ref) / cycle_time) + 1;
+        return t_ref + cycle_time * ticks - sc_time_stamp();
+    }
+
+    // Varianta SC_METHOD (-DROUTER_SC_METHOD): aceeasi logica, dar fara stiva proprie de corutina.
+    // Fiecare apel face un pas al masinii de stari si se reprogrameaza cu next_trigger().
+    void process_method() {
+        if (resume_at > SC_ZERO_TIME) { // reluare dintr-un checkpoint
+            if (sc_time_stamp() < resume_at) {
+                next_trigger(resume_at);
+                return;
+            }
+            resume_at = SC_ZERO_TIME;
+            init_wake_events();
+            if (engine_state == ST_ARBITRATE && next_tick > sc_time_stamp()) {
+                next_trigger(next_tick - sc_time_stamp());
+                return;
             }
+        }
 
-            // Iteram prin porturi incepand de la start_idx
-            for (int i = 0; i < 4; i++) { 
-                
-                // Calculam portul curent folosind modulo (%) pentru a ne invarti in cerc (ex: 3 -> 0)
-                int current_port = (start_idx + i) % 4;
+        switch (engine_state) {
+            case ST_IDLE:
+                if (wake_events.size() == 0) { // primul apel (la initializare), porturile sunt deja legate
+                    init_wake_events();
+                }
+                if (!has_work()) {
+                    next_trigger(sleep_events());
+                    return;
+                }
+                engine_state = ST_ARBITRATE;
+                next_tick = sc_time_stamp() + time_to_next_tick();
+                next_trigger(next_tick - sc_time_stamp());
+                return;
+
+            case ST_ARBITRATE:
+                if (!step()) { // iesirea e plina, asteptam sa se elibereze un loc
+                    engine_state = ST_BLOCKED;
+                    blocked_since = sc_time_stamp();
+                    next_trigger(lane_out(blocked_port)->data_read_event());
+                    return;
+                }
+                break;
+
+            case ST_BLOCKED:
+                if (!lane_out(blocked_port)->nb_write(blocked_pkt)) {
+                    next_trigger(lane_out(blocked_port)->data_read_event());
+                    return;
+                }
+                stats.blocked_time += sc_time_stamp() - blocked_since;
+                record_forward(events, edge_port, blocked_in, blocked_port % NUM_PORTS, blocked_pkt);
+                NOC_LOG(LOG_TRACE, " -> Fwd to Port " << PortNames[blocked_port % NUM_PORTS] << endl);
+                break;
+        }
 
-                // Dacă portul e dezactivat, îl sărim
-                if (!port_enabled[current_port]) continue;
+        // Ciclul s-a terminat: daca mai avem pachete mergem direct la urmatorul tick, altfel dormim
+        t_ref = sc_time_stamp();
+        if (has_work()) {
+            engine_state = ST_ARBITRATE;
+            next_tick = sc_time_stamp() + cycle_time;
+            next_trigger(cycle_time);
+        } else {
+            engine_state = ST_IDLE;
+            next_trigger(sleep_events());
+        }
+    }
+
+    // Un ciclu de procesare al routerului (config + arbitrare + rutare a cel mult unui pachet;
+    // in modul crossbar cel mult un pachet pe fiecare iesire, vezi crossbar_step()).
+    // Returneaza false doar in varianta SC_METHOD, cand pachetul ramane blocat pe o iesire plina.
+    bool step() {
+        // 1. VERIFICĂ CONFIGURAREA (Deci practic inainte de a procesa pachete, ne uitam daca avem noi comenzi de configurare)
+        cfg_trans cfg;
+        while (cfg_port.nb_read(cfg)) { //non-blocking read (daca nu e nimic de citit, trece mai departe)
+            handle_config(cfg); //caz in care ne ducem sa procesam comanda de configurare
+        }
+
+        if (switch_mode == SWITCH_CROSSBAR) return crossbar_step();
 
-                packet p;
-                if (in_ports[current_port].nb_read(p)) {
-                    cout << "@" << sc_time_stamp() << " [ROUTER] Pkt in port " << PortNames[current_port] << ": " << p;
+        // 2. ARBITRARE SI SELECTIE PORT
+        // Ordinea in care verificam intrarile depinde de arbitration_policy (vezi arbitration_order)
+        int order[NUM_LANES];
+        int n = arbitration_order(order);
+
+        for (int i = 0; i < n; i++) { 
+            
+            int lane = order[i];
+            int current_port = lane % NUM_PORTS;
+
+            // Dacă portul e dezactivat, îl sărim
+            if (!port_enabled[current_port]) continue;
+
+            packet p;
+            if (fetch_input(lane, p)) {
+                // Rutare (flit-urile BODY/TAIL urmeaza iesirea capului lor)
+                int out_idx = flit_output(lane, p);
+                int out_ln = (out_idx >= 0) ? out_lane(out_idx, p) : out_idx;
+
+                // Wormhole: iesirea e alocata altui pachet pana ii trece coada, lasam flit-ul in registru.
+                // Cu msg_classes nu asteptam nici o iesire plina: write() ar opri si cealalta clasa.
+                if (out_idx >= 0 && (!output_free_for(out_ln, lane) ||
+                                     (msg_classes && port_enabled[out_idx] && lane_out(out_ln)->num_free() == 0))) {
+                    in_head[lane] = p;
+                    head_valid[lane] = true;
+                    continue;
+                }
+                track_worm(lane, out_idx, p);
+
+                stats.arb_wins[current_port]++;
+                note_grant(current_port); // inainte de write(), care poate bloca (checkpoint)
+                record_grant(events, edge_port, current_port, out_idx, p);
+                NOC_LOG(LOG_TRACE, "@" << sc_time_stamp() << " [ROUTER] Pkt in port " << PortNames[current_port] << ": " << p);
+                
+                if (out_idx != RouteTable::NO_ROUTE) {
                     
-                    // Rutare
-                    if (routing_table.find(p.dst_id) != routing_table.end()) {
-                        int out_idx = routing_table[p.dst_id];
-                        
-                        if (port_enabled[out_idx]) {
-                             out_ports[out_idx].write(p);
-                             cout << " -> Fwd to Port " << PortNames[out_idx] << endl;
-                        } else {
-
-                            cout << " -> DROP: Port " << PortNames[out_idx] << " disabled" << endl;
-                        }
+                    if (port_enabled[out_idx]) {
+                         stats.forwarded[current_port][out_idx]++;
+#ifdef ROUTER_SC_METHOD
+                         if (!lane_out(out_ln)->nb_write(p)) { // nu avem voie sa blocam intr-un SC_METHOD
+                             blocked_pkt = p;
+                             blocked_port = out_ln;
+                             blocked_in = current_port;
+                             return false;
+                         }
+#else
+                         // Starea de blocare e tinuta in membri doar pentru checkpoint (vezi resume_thread)
+                         engine_state = ST_BLOCKED;
+                         blocked_pkt = p;
+                         blocked_port = out_ln;
+                         blocked_in = current_port;
+                         blocked_since = sc_time_stamp();
+                         lane_out(out_ln)->write(p);
+                         stats.blocked_time += sc_time_stamp() - blocked_since; // 0 daca iesirea avea loc
+                         engine_state = ST_ARBITRATE;
+#endif
+                         record_forward(events, edge_port, current_port, out_idx, p);
+                         NOC_LOG(LOG_TRACE, " -> Fwd to Port " << PortNames[out_idx] << endl);
                     } else {
-                        cout << " -> DROP: No route for Destination " << p.dst_id << endl;
+                        stats.drop_disabled++;
+                        record_drop(events, current_port, out_idx, p);
+                        NOC_LOG(LOG_TRACE, " -> DROP: Port " << PortNames[out_idx] << " disabled" << endl);
                     }
+                } else {
+                    stats.drop_no_route++;
+                    record_drop(events, current_port, out_idx, p);
+                    NOC_LOG(LOG_TRACE, " -> DROP: No route for Destination " << p.dst_id << endl);
+                }
+
+                break; 
+            }
+        }
+        return true;
+    }
+
+    // Ordinea de verificare a intrarilor (lane-urilor) in modul cu un singur grant pe ciclu; intoarce cate sunt:
+    //  PRIORITY = N, S, E, V, L; ROUND_ROBIN = incepand cu urmatorul dupa ultimul servit;
+    //  WEIGHTED_RR = ca ROUND_ROBIN, dar ultimul servit ramane primul cat timp mai are grant-uri in runda (arb_left);
+    //  OLDEST_FIRST = dupa inject_time-ul pachetului din fata fiecarei intrari (egalitatile se rup Round Robin).
+    // Cu msg_classes raspunsurile trec inaintea cererilor, in aceeasi ordine intre ele (vezi lane_before).
+    // Pentru OLDEST_FIRST / msg_classes mutam capetele FIFO-urilor in registrele in_head[], ca sa le putem compara.
+    int arbitration_order(int order[NUM_LANES]) {
+        int start = arb_start(arbitration_policy, last_served_port, arb_left);
+        int n = 0;
+        for (int i = 0; i < NUM_PORTS; i++) {
+            int port = (start + i) % NUM_PORTS;
+            if (msg_classes && lane_bound(NUM_PORTS + port)) order[n++] = NUM_PORTS + port;
+            order[n++] = port;
+        }
+        if (arbitration_policy != OLDEST_FIRST && !msg_classes) return n;
 
-                    // Actualizam ultimul port servit (imp pt Round Robin)
-                    last_served_port = current_port;
+        for (int i = 0; i < n; i++) {
+            int l = order[i];
+            if (port_enabled[l % NUM_PORTS] && !head_valid[l]) head_valid[l] = lane_in(l)->nb_read(in_head[l]);
+        }
+        std::stable_sort(order, order + n, [this](int a, int b) { return lane_before(a, b); });
+        return n;
+    }
+
+    // Pachetul din registrul lane-ului a trece inaintea celui din b? Intrarile goale la final, apoi raspunsurile
+    // inaintea cererilor (msg_classes), apoi cel mai vechi (OLDEST_FIRST); la egalitate decide ordinea Round Robin.
+    bool lane_before(int a, int b) const {
+        if (head_valid[a] != head_valid[b]) return head_valid[a];
+        if (!head_valid[a]) return false;
+        if (msg_classes && in_head[a].is_response() != in_head[b].is_response()) return in_head[a].is_response();
+        return arbitration_policy == OLDEST_FIRST && in_head[a].inject_time < in_head[b].inject_time;
+    }
+
+    // Intrarea in a primit grant-ul: actualizam starea arbitrului (Round Robin / runda WEIGHTED_RR)
+    void note_grant(int in) {
+        arb_left = arb_left_after(arbitration_policy, in, last_served_port, arb_left, arb_weight);
+        last_served_port = in;
+    }
+
+    // Urmatorul pachet de pe o intrare: intai cel retinut in registrul crossbar-ului (daca am schimbat modul), apoi FIFO-ul
+    bool fetch_input(int lane, packet& p) {
+        if (head_valid[lane]) {
+            p = in_head[lane];
+            head_valid[lane] = false;
+            return true;
+        }
+        return lane_in(lane)->nb_read(p);
+    }
+
+    // Pachetul din registrul intrarii poate pleca in ciclul asta? (iesirea e a lui si are loc, sau va fi aruncat)
+    bool head_can_move(int in) {
+        int out = flit_output(in, in_head[in]);
+        if (out == RouteTable::NO_ROUTE || !port_enabled[out]) return true;
+        int ol = out_lane(out, in_head[in]);
+        if (!output_free_for(ol, in)) return false;
+        return !nonblocking() || lane_out(ol)->num_free() > 0;
+    }
+
+    // Iesirea flit-ului: HEAD/SINGLE se ruteaza, BODY/TAIL merg dupa capul lor (fara sa mai consulte ruta)
+    int flit_output(int in, const packet& p) {
+        if (!p.is_head() && in_route[in] != NO_WORM) return in_route[in];
+        if (routing_mode == ROUTE_WEST_FIRST || routing_mode == ROUTE_ODD_EVEN) return adaptive_route(in, p);
+        return route(p.dst_id);
+    }
+
+    // in si out sunt lane-uri: cele doua clase pot avea fiecare cate un pachet in curs pe acelasi port
+    bool output_free_for(int out, int in) {
+        return out_owner[out] < 0 || out_owner[out] == in;
+    }
+
+    // Dupa ce flit-ul a plecat (sau a fost aruncat) pe decizia out: HEAD aloca iesirea, TAIL o elibereaza
+    void track_worm(int in, int out, const packet& p) {
+        if (p.is_head() && !p.is_tail()) {
+            in_route[in] = out;
+            if (out >= 0 && port_enabled[out]) out_owner[out_lane(out, p)] = in;
+        } else if (p.is_tail() && in_route[in] != NO_WORM) {
+            if (in_route[in] >= 0 && out_owner[out_lane(in_route[in], p)] == in) out_owner[out_lane(in_route[in], p)] = -1;
+            in_route[in] = NO_WORM;
+        }
+    }
 
-                    break; 
+    // Un ciclu in modul crossbar: alocator separabil cu o singura iteratie (ca iSLIP).
+    //  1. fiecare intrare cere iesirea pachetului din fata ei (doar daca iesirea are loc); cu msg_classes intai
+    //     pachetul de pe rsp_in, apoi cel de pe in_ports
+    //  2. fiecare iesire alege una dintre intrarile care o cer, dupa arbitration_policy (raspunsurile intai, vezi lane_before):
+    //     PRIORITY = intrarea cu indicele cel mai mic, ROUND_ROBIN = urmatoarea dupa ultima servita de iesirea asta,
+    //     WEIGHTED_RR = ca ROUND_ROBIN cu grant_left[] per iesire, OLDEST_FIRST = pachetul cu inject_time minim
+    // Toate perechile intrare/iesire fara conflict trec in acelasi ciclu. Nu blocam niciodata pe o iesire plina.
+    bool crossbar_step() {
+        int request[NUM_PORTS];  // lane-ul de iesire cerut de fiecare intrare, -1 = niciunul
+        int req_lane[NUM_PORTS]; // lane-ul de intrare din care vine cererea
+
+        for (int port = 0; port < NUM_PORTS; port++) {
+            request[port] = -1;
+            if (!port_enabled[port]) continue;
+
+            for (int in = NUM_PORTS + port; in >= 0 && request[port] < 0; in -= NUM_PORTS) {
+                if (!lane_bound(in)) continue;
+                if (!head_valid[in]) head_valid[in] = lane_in(in)->nb_read(in_head[in]);
+                if (!head_valid[in]) continue;
+
+                int out = flit_output(in, in_head[in]);
+                if (out == RouteTable::NO_ROUTE || !port_enabled[out]) { // drop-urile nu au nevoie de iesire
+                    track_worm(in, out, in_head[in]);
+                    stats.arb_wins[port]++;
+                    head_valid[in] = false;
+                    record_grant(events, edge_port, port, out, in_head[in]);
+                    record_drop(events, port, out, in_head[in]);
+                    NOC_LOG(LOG_TRACE, "@" << sc_time_stamp() << " [ROUTER] Pkt in port " << PortNames[port] << ": " << in_head[in]);
+                    if (out == RouteTable::NO_ROUTE) {
+                        stats.drop_no_route++;
+                        NOC_LOG(LOG_TRACE, " -> DROP: No route for Destination " << in_head[in].dst_id << endl);
+                    } else {
+                        stats.drop_disabled++;
+                        NOC_LOG(LOG_TRACE, " -> DROP: Port " << PortNames[out] << " disabled" << endl);
+                    }
+                    continue;
                 }
+                int ol = out_lane(out, in_head[in]);
+                if (output_free_for(ol, in) && lane_out(ol)->num_free() > 0) {
+                    request[port] = ol;
+                    req_lane[port] = in;
+                }
+            }
+        }
+
+        for (int out = 0; out < NUM_PORTS; out++) {
+            int start = arb_start(arbitration_policy, last_granted[out], grant_left[out]);
+            int in = -1;
+            for (int k = 0; k < NUM_PORTS; k++) {
+                int cand = (start + k) % NUM_PORTS;
+                if (request[cand] < 0 || request[cand] % NUM_PORTS != out) continue;
+                if (in < 0 || lane_before(req_lane[cand], req_lane[in])) in = cand;
+                if (arbitration_policy != OLDEST_FIRST && !msg_classes) break;
+            }
+            if (in < 0) continue;
+
+            int lane = req_lane[in];
+            lane_out(request[in])->nb_write(in_head[lane]); // are loc, am verificat num_free()
+            track_worm(lane, out, in_head[lane]);
+            head_valid[lane] = false;
+            grant_left[out] = arb_left_after(arbitration_policy, in, last_granted[out], grant_left[out], arb_weight);
+            last_granted[out] = in;
+            stats.arb_wins[in]++;
+            stats.forwarded[in][out]++;
+            record_grant(events, edge_port, in, out, in_head[lane]);
+            record_forward(events, edge_port, in, out, in_head[lane]);
+            NOC_LOG(LOG_TRACE, "@" << sc_time_stamp() << " [ROUTER] Pkt in port " << PortNames[in] << ": " << in_head[lane]
+                 << " -> Fwd to Port " << PortNames[out] << endl);
+        }
+        return true;
+    }
+
+    // Alege portul de iesire pentru destinatie (NO_ROUTE = nu avem ruta)
+    int route(int dst_id) {
+        if (routing_mode == ROUTE_XY) return xy_route(dst_id);
+        return routing_table.lookup(dst_id); // un singur acces in tabela densa
+    }
+
+    // Rutare dimension-order XY din coordonatele codificate in dst_id (vezi xy_route_port din utils.h)
+    int xy_route(int dst_id) {
+        return xy_route_port(my_x, my_y, dst_id);
+    }
+
+    // Rutare minima adaptiva: dintre iesirile productive permise de modelul de viraje (noc_types.h) o alegem pe
+    // cea cu cele mai multe locuri libere in FIFO-ul de iesire (al clasei pachetului). O iesire dezactivata sau tinuta de
+    // pachetul altei intrari (wormhole) conteaza ca plina; la egalitate ramane prima (X inainte de Y, ca XY).
+    // Decizia se reia la fiecare ciclu cat timp pachetul asteapta in registrul intrarii (crossbar).
+    int adaptive_route(int in, const packet& p) {
+        int cand[2];
+        int n = (routing_mode == ROUTE_WEST_FIRST) ? west_first_ports(my_x, my_y, p.dst_id, cand)
+                                                   : odd_even_ports(my_x, my_y, p.src_id, p.dst_id, cand);
+        if (n == 0) return L;
+
+        int best = cand[0], best_free = -1;
+        for (int k = 0; k < n; k++) {
+            int out = cand[k];
+            int ol = out_lane(out, p);
+            int free_slots = (port_enabled[out] && output_free_for(ol, in)) ? lane_out(ol)->num_free() : -1;
+            if (free_slots > best_free) {
+                best = out;
+                best_free = free_slots;
             }
         }
+        return best;
     }
 
     void handle_config(cfg_trans c) {
-        switch (c.type) {
-            case cfg_trans::SET_ROUTE:
-                routing_table[c.target] = c.value;
-                cout << "@" << sc_time_stamp() << " [CFG] Route: Dst " << c.target << "->Port " << PortNames[c.value] << endl;
-                break;
-            case cfg_trans::ENABLE_PORT:
-                port_enabled[c.target] = (c.value != 0);
-                cout << "@" << sc_time_stamp() << " [CFG] Port " << c.target << (c.value ? " ON" : " OFF") << endl;
-                break;
-            case cfg_trans::SET_ARBITER:
-                arbitration_policy = c.value;
-                cout << "@" << sc_time_stamp() << " [CFG] Arbiter changed to: " << (c.value ? "Round-Robin" : "Fixed Priority") << endl;
-                break;
+        if (c.type == cfg_trans::SET_SWITCH) { // doar Router are cele doua moduri (VCRouter e mereu crossbar)
+            switch_mode = c.value;
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Switch mode: " << (c.value == SWITCH_CROSSBAR ? "Crossbar" : "Single") << endl);
+            return;
+        }
+        if (c.type == cfg_trans::SET_Q_LEN) { // doar Router are intrarile pe sc_fifo_in (la VCRouter adancimea e in credite)
+            set_queue_length(c.target, c.value);
+            return;
+        }
+        apply_router_config(*this, c);
+    }
+
+    // SET_Q_LEN: noua capacitate a FIFO-ului de pe intrarea port (si a celui de raspunsuri, daca portul il are). Merge doar
+    // daca intrarea e legata la un stat_fifo (legaturile din Network / Mesh); porturile inchise sunt sc_fifo simple si nu se
+    // pot redimensiona.
+    void set_queue_length(int port, int len) {
+        stat_fifo<packet>* f = (port >= 0 && port < NUM_PORTS) ? dynamic_cast<stat_fifo<packet>*>(in_ports[port].get_interface()) : NULL;
+        if (f == NULL || len < 1) {
+            NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [CFG] ERROR: cannot set queue length " << len << " on port " << port << endl);
+            return;
+        }
+        f->set_capacity(len);
+        stat_fifo<packet>* r = lane_bound(NUM_PORTS + port) ? dynamic_cast<stat_fifo<packet>*>(lane_in(NUM_PORTS + port)) : NULL;
+        if (r != NULL) r->set_capacity(len);
+        NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [CFG] Queue length: Port " << PortNames[port] << " -> " << len << endl);
+    }
+
+    // Checkpoint: configuratia, registrele (crossbar / wormhole), contoarele si starea motorului de simulare
+    void save_state(ckpt_out& out) const {
+        out.section("RTR ");
+        out.items(routing_table.entries());
+        out.put(port_enabled);
+        int32_t cfg[7] = { arbitration_policy, last_served_port, switch_mode, routing_mode, my_x, my_y, arb_left };
+        out.put(cfg);
+        for (int i = 0; i < NUM_PORTS; i++) {
+            int32_t regs[3] = { last_granted[i], grant_left[i], arb_weight[i] };
+            out.put(regs);
+        }
+        for (int i = 0; i < NUM_LANES; i++) {
+            int32_t regs[3] = { head_valid[i], in_route[i], out_owner[i] };
+            out.put(regs);
+            out.pkt(in_head[i]);
         }
+        stats.save_state(out);
+        out.put<int32_t>(engine_state);
+        out.time(t_ref);
+        out.time(next_tick);
+        out.pkt(blocked_pkt);
+        out.put<int32_t>(blocked_port);
+        out.put<int32_t>(blocked_in);
+        out.time(blocked_since);
+    }
+
+    // Se apeleaza la elaborare; process() / process_method() continua de la momentul at
+    void load_state(ckpt_in& in, const sc_time& at) {
+        if (!in.section("RTR ")) return;
+        std::vector<int8_t> table;
+        in.items(table);
+        routing_table.clear();
+        routing_table.load(table, 0);
+        in.raw(port_enabled, sizeof(port_enabled));
+        int32_t cfg[7];
+        in.raw(cfg, sizeof(cfg));
+        arbitration_policy = cfg[0];
+        last_served_port = cfg[1];
+        switch_mode = cfg[2];
+        routing_mode = cfg[3];
+        my_x = cfg[4];
+        my_y = cfg[5];
+        arb_left = cfg[6];
+        for (int i = 0; i < NUM_PORTS; i++) {
+            int32_t regs[3];
+            in.raw(regs, sizeof(regs));
+            last_granted[i] = regs[0];
+            grant_left[i] = regs[1];
+            arb_weight[i] = regs[2];
+        }
+        for (int i = 0; i < NUM_LANES; i++) {
+            int32_t regs[3];
+            in.raw(regs, sizeof(regs));
+            head_valid[i] = regs[0] != 0;
+            in_route[i] = regs[1];
+            out_owner[i] = regs[2];
+            in_head[i] = in.pkt();
+        }
+        stats.load_state(in);
+        engine_state = in.get<int32_t>();
+        t_ref = in.time();
+        next_tick = in.time();
+        blocked_pkt = in.pkt();
+        blocked_port = in.get<int32_t>();
+        blocked_in = in.get<int32_t>();
+        blocked_since = in.time();
+        resume_at = at;
     }
 
     SC_CTOR(Router) {
+#ifdef ROUTER_SC_METHOD
+        SC_METHOD(process_method);
+#else
         SC_THREAD(process);
-        for(int i=0; i<4; i++) port_enabled[i] = true;
+#endif
+        for(int i=0; i<NUM_PORTS; i++) {
+            port_enabled[i] = true;
+            last_granted[i] = NUM_PORTS - 1;
+            grant_left[i] = 0;
+            arb_weight[i] = 1;
+            edge_port[i] = (i == L);
+        }
+        for (int i = 0; i < NUM_LANES; i++) {
+            head_valid[i] = false;
+            in_route[i] = NO_WORM;
+            out_owner[i] = -1;
+        }
+        msg_classes = false;
+        cycle_time = sc_time(10, SC_NS);
+        engine_state = ST_IDLE;
+        blocked_port = 0;
+        blocked_in = 0;
+        events = NULL;
         
         // Initializari default
         arbitration_policy = PRIORITY; // Pornim implicit cu Prioritate Fixa
-        last_served_port = 3; // Ca sa incepem cu 0 prima data daca trecem pe RR
+        last_served_port = NUM_PORTS - 1; // Ca sa incepem cu 0 prima data daca trecem pe RR
+        arb_left = 0;
+        switch_mode = SWITCH_SINGLE;
+        routing_mode = ROUTE_TABLE;
+        my_x = 0;
+        my_y = 0;
     }
 };
 
@@ -0,0 +1,339 @@
+// stats.h
+#ifndef STATS_H
+#define STATS_H
+
+#include <systemc.h>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <deque>
+#include "utils.h"
+#include "checkpoint.h"
+#include "event_log.h"
+
+// Contoarele unui router. Sunt doar incrementari de intregi pe calea critica,
+// deci pot ramane activate in orice rulare.
+struct RouterStats {
+    unsigned long forwarded[NUM_PORTS][NUM_PORTS]; // forwarded[in][out] = pachete trimise de pe intrarea in pe iesirea out
+    unsigned long arb_wins[NUM_PORTS];             // de cate ori a castigat fiecare intrare arbitrarea
+    unsigned long drop_no_route;                   // DROP: nu exista ruta pentru destinatie
+    unsigned long drop_disabled;                   // DROP: portul de iesire e dezactivat
+    sc_time blocked_time;                          // timpul petrecut blocat pe un out_ports[].write() plin
+
+    RouterStats() { reset(); }
+
+    void reset() {
+        for (int i = 0; i < NUM_PORTS; i++) {
+            arb_wins[i] = 0;
+            for (int o = 0; o < NUM_PORTS; o++) forwarded[i][o] = 0;
+        }
+        drop_no_route = 0;
+        drop_disabled = 0;
+        blocked_time = SC_ZERO_TIME;
+    }
+
+    // Total pachete scoase din intrari (forwardate sau aruncate)
+    unsigned long total_routed() const {
+        unsigned long sum = 0;
+        for (int i = 0; i < NUM_PORTS; i++) sum += arb_wins[i];
+        return sum;
+    }
+
+    void save_state(ckpt_out& out) const {
+        out.put(forwarded);
+        out.put(arb_wins);
+        out.put(drop_no_route);
+        out.put(drop_disabled);
+        out.time(blocked_time);
+    }
+
+    void load_state(ckpt_in& in) {
+        in.raw(forwarded, sizeof(forwarded));
+        in.raw(arb_wins, sizeof(arb_wins));
+        drop_no_route = in.get<unsigned long>();
+        drop_disabled = in.get<unsigned long>();
+        blocked_time = in.time();
+    }
+};
+
+// Evenimentele unui pachet pentru EventRecorder (event_log.h); ev = NULL inseamna ca inregistrarea e oprita,
+// deci pe calea critica ramane doar testul de pointer. edge[] = porturile routerului pe care stau periferice.
+inline void record_event(EventRecorder::Ring* ev, int kind, int in, int out, const packet& p) {
+    noc_event e;
+    e.time = sc_time_stamp().value();
+    e.inject = p.inject_time.value();
+    e.src_id = p.src_id;
+    e.dst_id = p.dst_id;
+    e.address = p.address;
+    e.tag = p.tag;
+    e.kind = (uint8_t)kind;
+    e.in_port = (in >= 0) ? (uint8_t)in : EV_NO_PORT;
+    e.out_port = (out >= 0) ? (uint8_t)out : EV_NO_PORT;
+    e.type = (uint8_t)p.type;
+    e.flit = (uint8_t)p.flit;
+    e.pad = 0;
+    ev->push(e);
+}
+
+// Pachetul de pe intrarea in a castigat arbitrarea spre out (INJECT inainte, daca vine de la un periferic)
+inline void record_grant(EventRecorder::Ring* ev, const bool edge[], int in, int out, const packet& p) {
+    if (ev == NULL) return;
+    if (edge[in]) record_event(ev, EV_INJECT, in, out, p);
+    record_event(ev, EV_ARB, in, out, p);
+}
+
+// Pachetul a fost scris in iesirea out (EJECT dupa, daca acolo sta un periferic)
+inline void record_forward(EventRecorder::Ring* ev, const bool edge[], int in, int out, const packet& p) {
+    if (ev == NULL) return;
+    record_event(ev, EV_FORWARD, in, out, p);
+    if (edge[out]) record_event(ev, EV_EJECT, in, out, p);
+}
+
+inline void record_drop(EventRecorder::Ring* ev, int in, int out, const packet& p) {
+    if (ev != NULL) record_event(ev, EV_DROP, in, out, p);
+}
+
+// Canalul folosit pentru legaturi: aceeasi interfata ca sc_fifo (sc_fifo_in / sc_fifo_out se leaga direct la el)
+// si aceeasi semantica (ce se scrie/citeste intr-un delta-ciclu devine vizibil dupa update), dar capacitatea se
+// poate schimba la runtime (set_capacity, SET_Q_LEN in Router) si canalul isi masoara singur ocupanta maxima
+// (high-water mark) si medie, cat timp a stat plin si cate scrieri au gasit FIFO-ul plin.
+// Nu are proces propriu si nu face sampling: contoarele se actualizeaza doar in update(), adica doar in
+// delta-ciclurile in care cineva a scris sau a citit din FIFO.
+template <class T>
+class stat_fifo : public sc_fifo_in_if<T>, public sc_fifo_out_if<T>, public sc_prim_channel {
+public:
+    stat_fifo(const char* name, int size = 16)
+        : sc_prim_channel(name), capacity(size), max_occupancy(0), write_stalls(0),
+          num_readable(0), num_read(0), num_written(0),
+          cur_occupancy(0), occupancy_integral(0.0) {}
+
+    int capacity;               // nu se modifica direct, doar prin set_capacity()
+    int max_occupancy;
+    unsigned long write_stalls; // scrieri care au gasit FIFO-ul plin (nb_write() refuzat sau write() care a asteptat)
+
+    // --- sc_fifo_in_if ---
+    int num_available() const { return num_readable - num_read; }
+
+    bool nb_read(T& v) {
+        if (num_available() == 0) return false;
+        v = buf.front();
+        buf.pop_front();
+        num_read++;
+        request_update();
+        return true;
+    }
+
+    void read(T& v) {
+        while (num_available() == 0) wait(written_event);
+        nb_read(v);
+    }
+
+    T read() {
+        T v;
+        read(v);
+        return v;
+    }
+
+    const sc_event& data_written_event() const { return written_event; }
+
+    // --- sc_fifo_out_if ---
+    // Un loc eliberat de o citire se poate folosi abia dupa update, ca la sc_fifo. Dupa o micsorare sub ocupanta
+    // curenta elementele raman in FIFO, dar nu mai intra altele pana nu scade ocupanta sub noua capacitate.
+    int num_free() const {
+        int n = capacity - num_readable - num_written;
+        return n > 0 ? n : 0;
+    }
+
+    bool nb_write(const T& v) {
+        if (num_free() == 0) {
+            write_stalls++;
+            return false;
+        }
+        buf.push_back(v);
+        num_written++;
+        request_update();
+        return true;
+    }
+
+    void write(const T& v) {
+        if (num_free() == 0) write_stalls++;
+        while (num_free() == 0) wait(read_event);
+        buf.push_back(v);
+        num_written++;
+        request_update();
+    }
+
+    const sc_event& data_read_event() const { return read_event; }
+
+    // Noua capacitate (>= 1). Cand creste, trezim scriitorii care asteapta loc (data_read_event).
+    void set_capacity(int n) {
+        if (n < 1) n = 1;
+        account(sc_time_stamp());
+        if (n > capacity) read_event.notify(SC_ZERO_TIME);
+        capacity = n;
+    }
+
+    // Ocupanta medie (numar de elemente) pe intervalul [0, acum]
+    double avg_occupancy() const {
+        double now = sc_time_stamp().to_seconds();
+        if (now <= 0.0) return cur_occupancy;
+        double integral = occupancy_integral + cur_occupancy * (now - last_change.to_seconds());
+        return integral / now;
+    }
+
+    // Cat timp a stat FIFO-ul plin (ocupanta >= capacitate) pana acum: timpul in care legatura nu mai primea nimic
+    sc_time full_time() const {
+        if (cur_occupancy < capacity) return full_integral;
+        return full_integral + (sc_time_stamp() - last_change);
+    }
+
+    // Checkpoint: capacitatea, continutul si contoarele. Aici avem acces la buffer, deci FIFO-ul nu se goleste.
+    void save_state(ckpt_out& out) {
+        out.put<int32_t>(capacity);
+        out.items(std::vector<T>(buf.begin(), buf.begin() + num_available()));
+        out.put<int32_t>(max_occupancy);
+        out.put(write_stalls);
+        out.put<int32_t>(cur_occupancy);
+        out.put(occupancy_integral);
+        out.time(full_integral);
+        out.time(last_change);
+    }
+
+    // La elaborare: elementele puse inapoi devin vizibile in primul update, unde ocupanta e deja cea salvata
+    void load_state(ckpt_in& in) {
+        capacity = in.get<int32_t>();
+        std::vector<T> items;
+        in.items(items);
+        if ((int)items.size() > capacity) in.fail(std::string("checkpoint does not fit in FIFO ") + name());
+        for (size_t i = 0; i < items.size(); i++) buf.push_back(items[i]);
+        num_written = (int)items.size();
+        if (num_written > 0) request_update();
+        max_occupancy = in.get<int32_t>();
+        write_stalls = in.get<unsigned long>();
+        cur_occupancy = in.get<int32_t>();
+        occupancy_integral = in.get<double>();
+        full_integral = in.time();
+        last_change = in.time();
+    }
+
+protected:
+    void update() {
+        if (num_read > 0) read_event.notify(SC_ZERO_TIME);
+        if (num_written > 0) written_event.notify(SC_ZERO_TIME);
+        num_readable = (int)buf.size();
+        num_read = 0;
+        num_written = 0;
+
+        // dupa update, num_available() e exact numarul de elemente din FIFO
+        int occ = num_readable;
+        if (occ != cur_occupancy) {
+            account(sc_time_stamp());
+            cur_occupancy = occ;
+            if (occ > max_occupancy) max_occupancy = occ;
+        }
+    }
+
+private:
+    // Aduna intervalul [last_change, now] la integralele de ocupanta si de timp plin
+    void account(const sc_time& now) {
+        occupancy_integral += cur_occupancy * (now - last_change).to_seconds();
+        if (cur_occupancy >= capacity) full_integral += now - last_change;
+        last_change = now;
+    }
+
+    std::deque<T> buf;  // elementele citibile in fata, cele scrise in delta-ciclul curent in spate
+    int num_readable;   // cate elemente erau in FIFO la ultimul update
+    int num_read;       // citite in delta-ciclul curent
+    int num_written;    // scrise in delta-ciclul curent
+    sc_event read_event, written_event;
+
+    int cur_occupancy;
+    double occupancy_integral; // suma (ocupanta * durata), in secunde
+    sc_time full_integral;     // timpul total cu ocupanta >= capacitate (fara intervalul curent)
+    sc_time last_change;
+};
+
+// ---------------------------------------------------------------------------------------------------
+// Raportul de final: CSV (routere, perechi intrare/iesire, legaturi) + JSON cu tot.
+// Sunt template-uri ca sa nu depindem de router.h (R = Router, cu membrii name() si stats).
+
+// Un rand per router: castiguri la arbitrare per intrare, drop-uri si ciclurile de blocare
+template <class R>
+void write_router_csv(const std::string& path, const std::vector<R*>& routers, const sc_time& cycle) {
+    std::ofstream f(path.c_str());
+    f << "router";
+    for (int i = 0; i < NUM_PORTS; i++) f << ",arb_wins_" << PortNames[i];
+    f << ",drop_no_route,drop_disabled,blocked_cycles\n";
+    for (size_t r = 0; r < routers.size(); r++) {
+        const RouterStats& s = routers[r]->stats;
+        f << routers[r]->name();
+        for (int i = 0; i < NUM_PORTS; i++) f << "," << s.arb_wins[i];
+        f << "," << s.drop_no_route << "," << s.drop_disabled << "," << s.blocked_time / cycle << "\n";
+    }
+}
+
+// Un rand per pereche intrare/iesire folosita
+template <class R>
+void write_forwarding_csv(const std::string& path, const std::vector<R*>& routers) {
+    std::ofstream f(path.c_str());
+    f << "router,in_port,out_port,packets\n";
+    for (size_t r = 0; r < routers.size(); r++) {
+        const RouterStats& s = routers[r]->stats;
+        for (int i = 0; i < NUM_PORTS; i++) {
+            for (int o = 0; o < NUM_PORTS; o++) {
+                if (s.forwarded[i][o] == 0) continue;
+                f << routers[r]->name() << "," << PortNames[i] << "," << PortNames[o] << "," << s.forwarded[i][o] << "\n";
+            }
+        }
+    }
+}
+
+// Un rand per legatura: capacitate, ocupanta maxima/medie, ciclurile in care a stat plina si scrierile refuzate
+template <class F>
+void write_link_csv(const std::string& path, const std::vector<F*>& links, const sc_time& cycle) {
+    std::ofstream f(path.c_str());
+    f << "link,capacity,max_occupancy,avg_occupancy,full_cycles,write_stalls\n";
+    for (size_t l = 0; l < links.size(); l++) {
+        f << links[l]->name() << "," << links[l]->capacity << "," << links[l]->max_occupancy << ","
+          << links[l]->avg_occupancy() << "," << links[l]->full_time() / cycle << "," << links[l]->write_stalls << "\n";
+    }
+}
+
+template <class R, class F>
+void write_stats_json(const std::string& path, const std::vector<R*>& routers, const std::vector<F*>& links, const sc_time& cycle) {
+    std::ofstream f(path.c_str());
+    f << "{\n  \"sim_time_ns\": " << sc_time_stamp().to_seconds() * 1e9 << ",\n  \"routers\": [\n";
+    for (size_t r = 0; r < routers.size(); r++) {
+        const RouterStats& s = routers[r]->stats;
+        f << "    {\"name\": \"" << routers[r]->name() << "\", \"forwarded\": [";
+        for (int i = 0; i < NUM_PORTS; i++) {
+            f << (i ? ", " : "") << "[";
+            for (int o = 0; o < NUM_PORTS; o++) f << (o ? ", " : "") << s.forwarded[i][o];
+            f << "]";
+        }
+        f << "], \"arb_wins\": [";
+        for (int i = 0; i < NUM_PORTS; i++) f << (i ? ", " : "") << s.arb_wins[i];
+        f << "], \"drop_no_route\": " << s.drop_no_route << ", \"drop_disabled\": " << s.drop_disabled
+          << ", \"blocked_cycles\": " << s.blocked_time / cycle << "}" << (r + 1 < routers.size() ? "," : "") << "\n";
+    }
+    f << "  ],\n  \"links\": [\n";
+    for (size_t l = 0; l < links.size(); l++) {
+        f << "    {\"name\": \"" << links[l]->name() << "\", \"capacity\": " << links[l]->capacity
+          << ", \"max_occupancy\": " << links[l]->max_occupancy << ", \"avg_occupancy\": " << links[l]->avg_occupancy()
+          << ", \"full_cycles\": " << links[l]->full_time() / cycle << ", \"write_stalls\": " << links[l]->write_stalls
+          << "}" << (l + 1 < links.size() ? "," : "") << "\n";
+    }
+    f << "  ]\n}\n";
+}
+
+// Scrie <prefix>_routers.csv, <prefix>_forwarding.csv, <prefix>_links.csv si <prefix>.json
+template <class R, class F>
+void dump_stats(const std::string& prefix, const std::vector<R*>& routers, const std::vector<F*>& links, const sc_time& cycle) {
+    write_router_csv(prefix + "_routers.csv", routers, cycle);
+    write_forwarding_csv(prefix + "_forwarding.csv", routers);
+    write_link_csv(prefix + "_links.csv", links, cycle);
+    write_stats_json(prefix + ".json", routers, links, cycle);
+    cout << "Stats written to " << prefix << "_*.csv and " << prefix << ".json" << endl;
+}
+
+#endif
@@ -0,0 +1,316 @@
+// Sweep de parametri peste simulatorul de trafic (L2_traffic.cpp), cu cautarea automata a punctului de saturatie.
+// Kernel-ul SystemC e unic per proces, deci fiecare configuratie ruleaza intr-un proces separat (fork + exec),
+// cate jobs in paralel. Din fiecare rulare citim linia "RESULT key=value ..." si punem totul intr-un singur tabel.
+// Nu are nevoie de SystemC:
+//   g++ -O2 -o sweep sweep.cpp
+//   ./sweep [sim=./traffic_sim] [jobs=<nr. de core-uri>] [out=sweep.csv]
+//           [rows=1] [cols=8] [depth=16] [arb=default] [routing=xy] [rate=0.05] [router=basic] [pattern=uniform]
+//           [saturate=0|1] [factor=3] [zero_rate=0.01] [tol=0.005]  [-- <alti parametri pentru sim>]
+// rows, cols, depth, arb, routing, rate, router si pattern accepta liste separate prin virgula (ex. depth=4,8,16);
+// se ruleaza toate combinatiile. Cu saturate=1 rate-ul nu mai e parcurs: pentru fiecare configuratie masuram
+// latenta la zero_rate (zero-load), apoi cautam binar cea mai mare rata la care reteaua inca se goleste si
+// latenta medie e sub factor * latenta zero-load, pana cand intervalul e mai mic decat tol.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+typedef map<string, string> Result; // cheile din linia RESULT
+
+// O rulare: argumentele pentru simulator si, dupa executie, rezultatul
+struct Job {
+    vector<string> args;
+    Result result;
+    bool ok;
+};
+
+static vector<string> split(const string& s, char sep) {
+    vector<string> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, sep)) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+static Result parse_result(const string& output) {
+    Result r;
+    size_t pos = output.rfind("RESULT ");
+    if (pos == string::npos) return r;
+    string line = output.substr(pos + 7, output.find('\n', pos) - pos - 7);
+    vector<string> kv = split(line, ' ');
+    for (size_t i = 0; i < kv.size(); i++) {
+        size_t eq = kv[i].find('=');
+        if (eq != string::npos) r[kv[i].substr(0, eq)] = kv[i].substr(eq + 1);
+    }
+    return r;
+}
+
+// Un proces copil care ruleaza simulatorul, cu stdout pe un pipe
+struct Worker {
+    pid_t pid;
+    int fd;
+    size_t job;
+    string output;
+};
+
+static bool spawn(const string& sim, Job& job, size_t index, Worker& w) {
+    int p[2];
+    if (pipe(p) != 0) return false;
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(p[0]);
+        close(p[1]);
+        return false;
+    }
+    if (pid == 0) {
+        dup2(p[1], STDOUT_FILENO);
+        close(p[0]);
+        close(p[1]);
+        vector<char*> argv;
+        argv.push_back((char*)sim.c_str());
+        for (size_t i = 0; i < job.args.size(); i++) argv.push_back((char*)job.args[i].c_str());
+        argv.push_back(NULL);
+        execv(sim.c_str(), argv.data());
+        fprintf(stderr, "sweep: cannot run %s: %s\n", sim.c_str(), strerror(errno));
+        _exit(127);
+    }
+    close(p[1]);
+    w.pid = pid;
+    w.fd = p[0];
+    w.job = index;
+    w.output.clear();
+    return true;
+}
+
+// Ruleaza toate job-urile, cel mult max_jobs procese in acelasi timp
+static void run_batch(const string& sim, vector<Job>& jobs, int max_jobs) {
+    vector<Worker> running;
+    size_t next = 0;
+    while (next < jobs.size() || !running.empty()) {
+        while (next < jobs.size() && (int)running.size() < max_jobs) {
+            Worker w;
+            jobs[next].ok = false;
+            if (spawn(sim, jobs[next], next, w)) running.push_back(w);
+            next++;
+        }
+        if (running.empty()) continue;
+
+        vector<pollfd> fds(running.size());
+        for (size_t i = 0; i < running.size(); i++) {
+            fds[i].fd = running[i].fd;
+            fds[i].events = POLLIN;
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0 && errno != EINTR) break;
+
+        for (size_t i = running.size(); i-- > 0;) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            char buf[4096];
+            ssize_t n = read(running[i].fd, buf, sizeof(buf));
+            if (n > 0) {
+                running[i].output.append(buf, n);
+                continue;
+            }
+            // EOF: procesul a terminat
+            close(running[i].fd);
+            int status = 0;
+            waitpid(running[i].pid, &status, 0);
+            Job& job = jobs[running[i].job];
+            job.result = parse_result(running[i].output);
+            job.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 && !job.result.empty();
+            running.erase(running.begin() + i);
+        }
+    }
+}
+
+static double num(const Result& r, const char* key) {
+    Result::const_iterator it = r.find(key);
+    return (it == r.end()) ? 0.0 : atof(it->second.c_str());
+}
+
+// Reteaua e saturata la o rata daca nu se goleste sau daca latenta depaseste pragul
+static bool saturated(const Job& j, double max_latency) {
+    return !j.ok || num(j.result, "drained") == 0 || num(j.result, "avg_lat") > max_latency;
+}
+
+int main(int argc, char* argv[]) {
+    string sim = "./traffic_sim", out_path = "sweep.csv";
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_jobs = (cores > 0) ? (int)cores : 1;
+    bool saturate = false;
+    double factor = 3.0, zero_rate = 0.01, tol = 0.005;
+
+    // Parametrii care se pot parcurge, in ordinea coloanelor din tabel
+    const char* swept[] = { "router", "rows", "cols", "depth", "arb", "routing", "pattern", "rate" };
+    const int NUM_SWEPT = 8;
+    map<string, vector<string> > values;
+    values["router"] = { "basic" };
+    values["rows"] = { "1" };
+    values["cols"] = { "8" };
+    values["depth"] = { "16" };
+    values["arb"] = { "default" };
+    values["routing"] = { "xy" };
+    values["pattern"] = { "uniform" };
+    values["rate"] = { "0.05" };
+    vector<string> extra = { "stats=none" };
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--") == 0) {
+            for (i++; i < argc; i++) extra.push_back(argv[i]);
+            break;
+        }
+        const char* eq = strchr(argv[i], '=');
+        if (eq == NULL) {
+            cout << "Bad argument '" << argv[i] << "' (expected key=value)" << endl;
+            return 1;
+        }
+        string key(argv[i], eq - argv[i]);
+        const char* val = eq + 1;
+        if (key == "sim") sim = val;
+        else if (key == "jobs") max_jobs = atoi(val);
+        else if (key == "out") out_path = val;
+        else if (key == "saturate") saturate = atoi(val) != 0;
+        else if (key == "factor") factor = atof(val);
+        else if (key == "zero_rate") zero_rate = atof(val);
+        else if (key == "tol") tol = atof(val);
+        else if (values.count(key)) values[key] = split(val, ',');
+        else {
+            cout << "Unknown parameter '" << key << "'" << endl;
+            return 1;
+        }
+    }
+    if (max_jobs < 1) max_jobs = 1;
+    if (saturate) values["rate"] = { "0" }; // rata o alege cautarea
+
+    // Produsul cartezian al listelor
+    vector<vector<string> > configs(1);
+    for (int k = 0; k < NUM_SWEPT; k++) {
+        vector<vector<string> > next;
+        const vector<string>& vals = values[swept[k]];
+        for (size_t c = 0; c < configs.size(); c++) {
+            for (size_t v = 0; v < vals.size(); v++) {
+                next.push_back(configs[c]);
+                next.back().push_back(vals[v]);
+            }
+        }
+        configs.swap(next);
+    }
+
+    auto make_job = [&](const vector<string>& cfg, double rate) {
+        Job j;
+        for (int k = 0; k < NUM_SWEPT; k++) {
+            string v = cfg[k];
+            if (string(swept[k]) == "rate" && rate >= 0) {
+                ostringstream r;
+                r << rate;
+                v = r.str();
+            }
+            j.args.push_back(string(swept[k]) + "=" + v);
+        }
+        j.args.insert(j.args.end(), extra.begin(), extra.end());
+        j.ok = false;
+        return j;
+    };
+
+    cout << "--- SWEEP: " << configs.size() << " configurations, " << max_jobs << " parallel jobs, sim " << sim
+         << (saturate ? ", saturation search" : "") << " ---" << endl;
+
+    vector<Job> final_jobs;   // o linie de tabel per configuratie
+    vector<double> zero_lat;  // doar la saturate
+    vector<double> sat_rate;
+
+    if (!saturate) {
+        for (size_t c = 0; c < configs.size(); c++) final_jobs.push_back(make_job(configs[c], -1));
+        run_batch(sim, final_jobs, max_jobs);
+    } else {
+        // 1. latenta zero-load
+        vector<Job> zl;
+        for (size_t c = 0; c < configs.size(); c++) zl.push_back(make_job(configs[c], zero_rate));
+        run_batch(sim, zl, max_jobs);
+
+        // 2. cautare binara pe rata, toate configuratiile in paralel (un proces per configuratie la fiecare pas)
+        vector<double> lo(configs.size(), zero_rate), hi(configs.size(), 1.0);
+        vector<Job> best = zl;
+        for (size_t c = 0; c < configs.size(); c++) zero_lat.push_back(num(zl[c].result, "avg_lat"));
+        while (true) {
+            vector<Job> probes;
+            vector<size_t> owner;
+            for (size_t c = 0; c < configs.size(); c++) {
+                if (!zl[c].ok || hi[c] - lo[c] <= tol) continue;
+                probes.push_back(make_job(configs[c], (lo[c] + hi[c]) / 2));
+                owner.push_back(c);
+            }
+            if (probes.empty()) break;
+            run_batch(sim, probes, max_jobs);
+            for (size_t i = 0; i < probes.size(); i++) {
+                size_t c = owner[i];
+                double mid = (lo[c] + hi[c]) / 2;
+                if (saturated(probes[i], factor * zero_lat[c])) {
+                    hi[c] = mid;
+                } else {
+                    lo[c] = mid;
+                    best[c] = probes[i];
+                }
+            }
+        }
+        final_jobs = best;
+        sat_rate = lo;
+    }
+
+    // Tabelul: parametrii configuratiei + rezultatele
+    const char* metrics[] = { "offered", "accepted", "avg_lat", "p99_lat", "max_lat", "drained" };
+    const int NUM_METRICS = 6;
+    ofstream csv(out_path.c_str());
+    for (int k = 0; k < NUM_SWEPT; k++) {
+        cout << setw(11) << swept[k];
+        csv << (k ? "," : "") << swept[k];
+    }
+    for (int m = 0; m < NUM_METRICS; m++) {
+        cout << setw(11) << metrics[m];
+        csv << "," << metrics[m];
+    }
+    if (saturate) {
+        cout << setw(11) << "zero_lat" << setw(11) << "sat_rate";
+        csv << ",zero_lat,sat_rate";
+    }
+    cout << endl;
+    csv << "\n";
+
+    int failed = 0;
+    for (size_t c = 0; c < final_jobs.size(); c++) {
+        const Job& j = final_jobs[c];
+        for (int k = 0; k < NUM_SWEPT; k++) {
+            string v = j.args[k].substr(j.args[k].find('=') + 1);
+            cout << setw(11) << v;
+            csv << (k ? "," : "") << v;
+        }
+        if (!j.ok) failed++;
+        for (int m = 0; m < NUM_METRICS; m++) {
+            string v = j.ok ? j.result.at(metrics[m]) : "FAILED";
+            cout << setw(11) << v;
+            csv << "," << v;
+        }
+        if (saturate) {
+            cout << setw(11) << fixed << setprecision(3) << zero_lat[c] << setw(11) << setprecision(4) << sat_rate[c];
+            csv << "," << zero_lat[c] << "," << sat_rate[c];
+            cout.unsetf(ios::floatfield);
+        }
+        cout << endl;
+        csv << "\n";
+    }
+    cout << "Table written to " << out_path << (failed ? " (" + to_string(failed) + " runs failed)" : "") << endl;
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+// topology.h
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <vector>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include "route_table.h"
+
+// Graful retelei: routerele sunt noduri, fiecare legatura router -> router e o muchie orientata etichetata cu
+// portul de iesire si un cost (1 = un hop; altfel ex. latenta legaturii). Perifericele (CPU/MEM) sunt puncte
+// terminale atasate pe un port al unui router. Graful se construieste pe masura ce se leaga reteaua, iar
+// compute_routes() da direct tabelele de rutare minime pentru toate routerele, fara cfg_trans.
+// Nu depinde de SystemC, ca sa poata fi folosit si in benchmark-uri.
+class Topology {
+public:
+    explicit Topology(int routers = 0) : out(routers), in(routers), unit_weights(true) {}
+
+    int num_routers() const { return (int)out.size(); }
+
+    int add_router() {
+        out.push_back(std::vector<Link>());
+        in.push_back(std::vector<Link>());
+        return num_routers() - 1;
+    }
+
+    // Iesirea port a routerului from intra in routerul to
+    void add_link(int from, int port, int to, double weight = 1.0) {
+        out[from].push_back(Link{ port, to, weight });
+        in[to].push_back(Link{ port, from, weight });
+        if (weight != 1.0) unit_weights = false;
+    }
+
+    // Perifericul cu id-ul dat sta pe portul port al routerului router
+    void add_endpoint(int id, int router, int port) {
+        endpoints.push_back(Endpoint{ id, router, port });
+    }
+
+    // Costul drumului minim de la fiecare router pana la routerul dst (infinit = inaccesibil)
+    std::vector<double> distances_to(int dst) const {
+        std::vector<double> dist;
+        std::vector<int8_t> port;
+        search(dst, dist, port);
+        return dist;
+    }
+
+    // Tabelele de rutare pentru toate routerele: tables[r][id] = portul de iesire spre perifericul id
+    // (RouteTable::NO_ROUTE daca nu e accesibil). O cautare din fiecare router la care sta macar un periferic;
+    // perifericul de pe routerul curent iese direct pe portul lui.
+    std::vector<std::vector<int8_t> > compute_routes() const {
+        int max_id = -1;
+        for (size_t e = 0; e < endpoints.size(); e++) {
+            if (endpoints[e].id > max_id) max_id = endpoints[e].id;
+        }
+        std::vector<std::vector<int8_t> > tables(num_routers(), std::vector<int8_t>(max_id + 1, (int8_t)RouteTable::NO_ROUTE));
+
+        // next[t][u] = portul lui u spre routerul t; il transpunem la final in tabelele pe routere
+        std::vector<std::vector<int8_t> > next(num_routers());
+        std::vector<double> dist;
+        for (size_t e = 0; e < endpoints.size(); e++) {
+            int t = endpoints[e].router;
+            if (next[t].empty()) search(t, dist, next[t]);
+        }
+
+        // Transpunere pe blocuri, altfel fiecare scriere din tables[u][id] ar atinge alta linie de cache
+        const int BLOCK = 64;
+        for (size_t e0 = 0; e0 < endpoints.size(); e0 += BLOCK) {
+            size_t e1 = std::min(endpoints.size(), e0 + BLOCK);
+            for (int u = 0; u < num_routers(); u++) {
+                int8_t* row = tables[u].data();
+                for (size_t e = e0; e < e1; e++) {
+                    const Endpoint& ep = endpoints[e];
+                    row[ep.id] = (u == ep.router) ? (int8_t)ep.port : next[ep.router][u];
+                }
+            }
+        }
+        return tables;
+    }
+
+private:
+    // Drumurile minime spre dst, pe muchiile inversate: BFS daca toate legaturile au cost 1, altfel Dijkstra.
+    // port[u] = iesirea lui u pe un drum minim; cand mai multi vecini dau acelasi cost castiga portul cu
+    // indicele cel mai mic (in mesh: intai N/S, apoi E/V, deci tot o rutare pe dimensiuni, fara cicluri).
+    void search(int dst, std::vector<double>& dist, std::vector<int8_t>& port) const {
+        const double INF = std::numeric_limits<double>::infinity();
+        dist.assign(num_routers(), INF);
+        port.assign(num_routers(), (int8_t)RouteTable::NO_ROUTE);
+        dist[dst] = 0;
+
+        if (unit_weights) {
+            // BFS pe niveluri: u e descoperit prima data din nivelul minim, restul muchiilor din acelasi nivel
+            // mai pot doar micsora portul
+            std::vector<int> frontier(1, dst);
+            frontier.reserve(num_routers());
+            for (size_t head = 0; head < frontier.size(); head++) {
+                int v = frontier[head];
+                double d = dist[v] + 1;
+                const Link* l = in[v].data();
+                for (size_t i = 0, n = in[v].size(); i < n; i++) {
+                    int u = l[i].to;
+                    if (dist[u] == INF) {
+                        dist[u] = d;
+                        port[u] = (int8_t)l[i].port;
+                        frontier.push_back(u);
+                    } else if (dist[u] == d && l[i].port < port[u]) {
+                        port[u] = (int8_t)l[i].port;
+                    }
+                }
+            }
+            return;
+        }
+
+        typedef std::pair<double, int> Item;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item> > pq;
+        pq.push(Item(0, dst));
+        while (!pq.empty()) {
+            Item top = pq.top();
+            pq.pop();
+            int v = top.second;
+            if (top.first > dist[v]) continue;
+            for (size_t i = 0; i < in[v].size(); i++) {
+                const Link& l = in[v][i];
+                double d = dist[v] + l.weight;
+                if (d < dist[l.to]) {
+                    dist[l.to] = d;
+                    port[l.to] = (int8_t)l.port;
+                    pq.push(Item(d, l.to));
+                } else if (d == dist[l.to] && l.port < port[l.to]) {
+                    port[l.to] = (int8_t)l.port;
+                }
+            }
+        }
+        port[dst] = (int8_t)RouteTable::NO_ROUTE; // legaturile de cost 0 nu fac ruta spre routerul insusi
+    }
+
+    struct Link {
+        int port;      // portul de iesire al routerului sursa
+        int to;        // in out[]: routerul destinatie; in in[]: routerul sursa
+        double weight;
+    };
+    struct Endpoint {
+        int id;
+        int router;
+        int port;
+    };
+
+    std::vector<std::vector<Link> > out; // out[r] = legaturile care pleaca din r
+    std::vector<std::vector<Link> > in;  // in[r] = legaturile care intra in r (pentru cautarea inversa)
+    std::vector<Endpoint> endpoints;
+    bool unit_weights;
+};
+
+#endif
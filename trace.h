@@ -0,0 +1,222 @@
+// trace.h
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Trace binar de acces la memorie, redat de CPU (set_trace) in locul tiparului fix WRITE / READ.
+// Fisierul: un antet de 16 octeti (magic "NOCTRC1\0", dimensiunea unei inregistrari, 0) urmat de inregistrari
+// trace_record de 24 de octeti, in ordinea de octeti a host-ului, sortate dupa cycle.
+// Numarul de inregistrari vine din dimensiunea fisierului, deci un trace scris pe jumatate (proces oprit) ramane citibil.
+// Nu depinde de SystemC, ca sa poata fi folosit si in benchmark-uri / generatoare.
+
+enum TraceOp { TRACE_READ = 0, TRACE_WRITE = 1 };
+
+struct trace_record {
+    uint64_t cycle;  // ciclul (de la pornirea CPU-ului) la care a plecat cererea in captura
+    int32_t type;    // TRACE_READ / TRACE_WRITE
+    int32_t dst_id;  // memoria destinatie
+    int32_t address;
+    int32_t data;    // doar la TRACE_WRITE
+};
+static_assert(sizeof(trace_record) == 24, "trace_record must stay 24 bytes (file format)");
+
+static const char TRACE_MAGIC[8] = { 'N', 'O', 'C', 'T', 'R', 'C', '1', '\0' };
+static const size_t TRACE_HEADER_BYTES = 16;
+
+// Scriere cu buffer: inregistrarile se strang in memorie si pleaca in fisier in blocuri mari
+class TraceWriter {
+public:
+    TraceWriter() : f(NULL), written(0) {}
+    ~TraceWriter() { close(); }
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    static const size_t BUFFER_RECORDS = 1 << 16; // 1.5 MB
+
+    bool open(const std::string& path) {
+        close();
+        f = fopen(path.c_str(), "wb");
+        if (f == NULL) return false;
+        uint32_t hdr[2] = { (uint32_t)sizeof(trace_record), 0 };
+        buf.reserve(BUFFER_RECORDS);
+        written = 0;
+        return fwrite(TRACE_MAGIC, 1, sizeof(TRACE_MAGIC), f) == sizeof(TRACE_MAGIC) && fwrite(hdr, 1, sizeof(hdr), f) == sizeof(hdr);
+    }
+
+    bool append(const trace_record& r) {
+        buf.push_back(r);
+        if (buf.size() == BUFFER_RECORDS) return flush();
+        return true;
+    }
+
+    uint64_t records() const { return written + buf.size(); }
+
+    // Intoarce false daca vreo scriere a esuat (ex. disc plin)
+    bool close() {
+        if (f == NULL) return true;
+        bool ok = flush();
+        ok = (fclose(f) == 0) && ok;
+        f = NULL;
+        return ok;
+    }
+
+private:
+    bool flush() {
+        if (buf.empty()) return true;
+        size_t n = fwrite(buf.data(), sizeof(trace_record), buf.size(), f);
+        written += n;
+        bool ok = (n == buf.size());
+        buf.clear();
+        return ok;
+    }
+
+    FILE* f;
+    std::vector<trace_record> buf;
+    uint64_t written;
+};
+
+// Citire secventiala fara sa tinem tot trace-ul in RAM, in unul din doua moduri:
+//  - MMAP: fisierul e mapat o data (read-only); kernelul aduce paginile la cerere (MADV_SEQUENTIAL face read-ahead),
+//    iar paginile deja citite sunt eliberate din WINDOW_BYTES in WINDOW_BYTES (MADV_DONTNEED), deci memoria
+//    rezidenta ramane cam o fereastra oricat de mare ar fi fisierul
+//  - CHUNKED: pread in blocuri de CHUNK_RECORDS, pentru sisteme fara spatiu de adrese pentru tot fisierul
+//    (MMAP cade automat pe CHUNKED daca maparea esueaza)
+class TraceReader {
+public:
+    enum Mode { MMAP = 0, CHUNKED = 1 };
+
+    TraceReader() : mode(MMAP), fd(-1), map_base(NULL), map_len(0), released(0), count(0), pos(0), chunk_first(0) {}
+    ~TraceReader() { close(); }
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    static const size_t WINDOW_BYTES = 64 << 20;
+    static const size_t CHUNK_RECORDS = 1 << 16;
+
+    std::string error; // motivul pentru care open() a intors false
+
+    bool open(const std::string& path, Mode m = MMAP) {
+        close();
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail("cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0) return fail("cannot stat " + path);
+
+        char hdr[TRACE_HEADER_BYTES];
+        uint32_t rec_size = 0;
+        if (pread(fd, hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) || memcmp(hdr, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+            return fail(path + " is not a trace file");
+        }
+        memcpy(&rec_size, hdr + sizeof(TRACE_MAGIC), sizeof(rec_size));
+        if (rec_size != sizeof(trace_record)) return fail(path + ": unsupported record size " + std::to_string(rec_size));
+        count = ((uint64_t)st.st_size - TRACE_HEADER_BYTES) / sizeof(trace_record);
+
+        mode = m;
+        if (mode == MMAP && count > 0) {
+            map_len = (size_t)st.st_size;
+            void* p = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                mode = CHUNKED;
+                map_len = 0;
+            } else {
+                map_base = (const char*)p;
+                madvise(p, map_len, MADV_SEQUENTIAL);
+            }
+        }
+        seek(0);
+        return true;
+    }
+
+    Mode active_mode() const { return mode; }
+    uint64_t size() const { return count; }
+    uint64_t position() const { return pos; }
+
+    // Urmatoarea inregistrare; false la sfarsitul trace-ului
+    bool next(trace_record& r) {
+        if (pos >= count) return false;
+        if (mode == MMAP) {
+            size_t off = TRACE_HEADER_BYTES + (size_t)pos * sizeof(trace_record);
+            memcpy(&r, map_base + off, sizeof(r));
+            if (off >= released + 2 * WINDOW_BYTES) release(off - WINDOW_BYTES);
+        } else {
+            if (pos >= chunk_first + chunk.size() && !fill()) return false;
+            r = chunk[pos - chunk_first];
+        }
+        pos++;
+        return true;
+    }
+
+    // Repozitionare (ex. reluare dintr-un checkpoint); index > size() = la sfarsit
+    void seek(uint64_t index) {
+        pos = (index > count) ? count : index;
+        if (mode == MMAP) {
+            released = 0;
+        } else {
+            chunk.clear();
+            chunk_first = pos;
+        }
+    }
+
+    void close() {
+        if (map_base) munmap((void*)map_base, map_len);
+        if (fd >= 0) ::close(fd);
+        map_base = NULL;
+        map_len = 0;
+        fd = -1;
+        count = pos = chunk_first = 0;
+        released = 0;
+        chunk.clear();
+        chunk.shrink_to_fit();
+    }
+
+private:
+    bool fail(const std::string& msg) {
+        error = msg;
+        close();
+        return false;
+    }
+
+    // Elibereaza paginile mapate de la released pana la up_to (rotunjit in jos la pagina)
+    void release(size_t up_to) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t end = up_to / page * page;
+        if (end > released) madvise((void*)(map_base + released), end - released, MADV_DONTNEED);
+        released = end;
+    }
+
+    bool fill() {
+        chunk_first = pos;
+        size_t n = (size_t)std::min<uint64_t>(CHUNK_RECORDS, count - pos);
+        chunk.resize(n);
+        off_t off = (off_t)(TRACE_HEADER_BYTES + pos * sizeof(trace_record));
+        ssize_t got = pread(fd, chunk.data(), n * sizeof(trace_record), off);
+        if (got != (ssize_t)(n * sizeof(trace_record))) {
+            chunk.clear();
+            count = pos; // fisier trunchiat intre timp: ne oprim aici
+            return false;
+        }
+        return true;
+    }
+
+    Mode mode;
+    int fd;
+    const char* map_base;
+    size_t map_len;
+    size_t released; // MMAP: octetii de la inceputul maparii deja eliberati
+    uint64_t count;
+    uint64_t pos;
+    std::vector<trace_record> chunk; // CHUNKED: inregistrarile [chunk_first, chunk_first + chunk.size())
+    uint64_t chunk_first;
+};
+
+#endif
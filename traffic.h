@@ -0,0 +1,219 @@
+// traffic.h
+#ifndef TRAFFIC_H
+#define TRAFFIC_H
+
+#include <systemc.h>
+#include <deque>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include "utils.h"
+#include "log.h"
+
+// Tiparele de trafic sintetic clasice (destinatia e calculata din coordonatele sursei)
+enum TrafficPattern {
+    TRAFFIC_UNIFORM = 0,    // destinatie aleatoare uniforma (diferita de sursa)
+    TRAFFIC_HOTSPOT = 1,    // cu probabilitatea hotspot_frac mergem la hotspot_id, altfel uniform
+    TRAFFIC_TRANSPOSE = 2,  // (x, y) -> (y, x)
+    TRAFFIC_BITCOMP = 3,    // bit-complement: (x, y) -> (cols-1-x, rows-1-y)
+    TRAFFIC_NEIGHBOUR = 4   // vecinul din dreapta: (x, y) -> ((x+1) % cols, y)
+};
+const char* TrafficPatternNames[] = { "uniform", "hotspot", "transpose", "bitcomp", "neighbour" };
+
+// Procesul de sosire al pachetelor la sursa
+enum InjectionProcess {
+    INJECT_BERNOULLI = 0, // in fiecare ciclu se genereaza un pachet cu probabilitatea rate
+    INJECT_POISSON = 1    // timpii dintre pachete sunt exponentiali, cu media cycle / rate
+};
+
+// Parametrii comuni ai tuturor generatoarelor dintr-o simulare
+struct TrafficConfig {
+    int pattern;          // TrafficPattern
+    int process;          // InjectionProcess
+    double rate;          // sarcina oferita: pachete / ciclu / nod
+    int hotspot_id;       // pentru TRAFFIC_HOTSPOT
+    double hotspot_frac;  // pentru TRAFFIC_HOTSPOT
+    unsigned seed;
+    sc_time cycle;        // ciclul la care se raporteaza rate si latenta (10 ns, ca routerul)
+    sc_time warmup;       // pachetele generate inainte de warmup nu intra in statistici
+    sc_time measure;      // fereastra de masura: [warmup, warmup + measure)
+
+    TrafficConfig()
+        : pattern(TRAFFIC_UNIFORM), process(INJECT_BERNOULLI), rate(0.1), hotspot_id(0), hotspot_frac(0.2), seed(1),
+          cycle(10, SC_NS), warmup(10, SC_US), measure(50, SC_US) {}
+
+    bool in_window(const sc_time& t) const { return t >= warmup && t < warmup + measure; }
+};
+
+// Latentele pachetelor masurate (in cicluri), ca sa putem calcula media si coada distributiei
+struct LatencyStats {
+    std::vector<double> samples;
+
+    void add(double cycles) { samples.push_back(cycles); }
+    void merge(const LatencyStats& o) { samples.insert(samples.end(), o.samples.begin(), o.samples.end()); }
+    size_t count() const { return samples.size(); }
+
+    double avg() const {
+        if (samples.empty()) return 0.0;
+        double sum = 0.0;
+        for (size_t i = 0; i < samples.size(); i++) sum += samples[i];
+        return sum / samples.size();
+    }
+
+    // Percentila p (0..100), metoda nearest-rank
+    double percentile(double p) const {
+        if (samples.empty()) return 0.0;
+        std::vector<double> s(samples);
+        size_t k = (size_t)std::ceil(p / 100.0 * s.size());
+        if (k > 0) k--;
+        if (k >= s.size()) k = s.size() - 1;
+        std::nth_element(s.begin(), s.begin() + k, s.end());
+        return s[k];
+    }
+
+    double max() const {
+        return samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end());
+    }
+};
+
+// Generator de trafic sintetic. Are aceleasi porturi ca CPU (out_port / in_port), deci se ataseaza
+// pe portul local al unui router la fel ca un CPU, dar e in acelasi timp si sursa si destinatie:
+// trimite pachete REQ_WRITE catre alte generatoare si consuma (ejecteaza) pachetele primite.
+//  - generate(): creeaza pachete dupa procesul de sosire si le pune in coada sursei (nelimitata),
+//    astfel incat sarcina oferita nu depinde de cat de aglomerata e reteaua
+//  - send(): scoate pachete din coada sursei si le scrie in retea (blocant, cu backpressure)
+//  - sink(): citeste pachetele sosite si noteaza latenta (ejectare - inject_time)
+// Latenta include si timpul de asteptare in coada sursei, ca in caracterizarile load-latency clasice.
+SC_MODULE(TrafficGen) {
+    sc_fifo_out<packet> out_port; // Iesire: pachete injectate in retea
+    sc_fifo_in<packet>  in_port;  // Intrare: pachete ejectate din retea
+
+    int my_id;        // xy_id(x, y) al routerului la care e atasat
+    int rows, cols;   // dimensiunile mesh-ului (pentru calculul destinatiei)
+    TrafficConfig cfg;
+
+    // Contoare (doar pachetele din fereastra de masura intra in latency / measured_*)
+    unsigned long generated;          // toate pachetele create
+    unsigned long sent;               // toate pachetele scrise in retea
+    unsigned long received;           // toate pachetele primite
+    unsigned long measured_generated; // create in fereastra de masura
+    unsigned long measured_received;  // primite, dintre cele create in fereastra de masura
+    unsigned long window_received;    // primite (indiferent cand au fost create) in timpul ferestrei
+    LatencyStats latency;
+
+    bool stopped; // dupa stop() nu mai generam pachete noi
+
+    void stop() { stopped = true; }
+
+    // Pachete create dar inca neinjectate
+    size_t source_queue_len() const { return source_queue.size(); }
+
+    void generate() {
+        while (!stopped) {
+            wait(next_arrival());
+            if (stopped) break;
+
+            packet p(packet::REQ_WRITE, my_id, pick_destination(), (int)generated, (int)generated);
+            p.inject_time = sc_time_stamp();
+            generated++;
+            if (cfg.in_window(p.inject_time)) measured_generated++;
+
+            source_queue.push_back(p);
+            queue_event.notify(SC_ZERO_TIME);
+        }
+    }
+
+    void send() {
+        while (true) {
+            while (source_queue.empty()) wait(queue_event);
+
+            packet p = source_queue.front();
+            source_queue.pop_front();
+            out_port.write(p); // blocant cand legatura catre router e plina
+            sent++;
+        }
+    }
+
+    void sink() {
+        while (true) {
+            packet p = in_port.read();
+            received++;
+
+            if (p.dst_id != my_id) {
+                NOC_LOG(LOG_ERROR, "@" << sc_time_stamp() << " [TRAFFIC " << my_id << "] ERROR: misrouted packet " << p << endl);
+            }
+
+            if (cfg.in_window(sc_time_stamp())) window_received++;
+            if (cfg.in_window(p.inject_time)) {
+                measured_received++;
+                latency.add((sc_time_stamp() - p.inject_time) / cfg.cycle);
+            }
+            NOC_LOG(LOG_DEBUG, "@" << sc_time_stamp() << " [TRAFFIC " << my_id << "] RECV: " << p << endl);
+        }
+    }
+
+    SC_HAS_PROCESS(TrafficGen);
+
+    TrafficGen(sc_module_name name, int id, int r, int c, const TrafficConfig& config)
+        : sc_module(name), my_id(id), rows(r), cols(c), cfg(config),
+          generated(0), sent(0), received(0), measured_generated(0), measured_received(0), window_received(0),
+          stopped(false), rng(config.seed * 7919u + (unsigned)id), uni(0.0, 1.0)
+    {
+        SC_THREAD(generate);
+        SC_THREAD(send);
+        SC_THREAD(sink);
+    }
+
+private:
+    std::deque<packet> source_queue;
+    sc_event queue_event;
+    std::mt19937 rng;
+    std::uniform_real_distribution<double> uni;
+
+    // Timpul pana la urmatorul pachet. La Bernoulli sarim direct peste ciclurile fara pachet
+    // (distributie geometrica), ca generatorul sa nu se trezeasca in fiecare ciclu la sarcina mica.
+    sc_time next_arrival() {
+        if (cfg.rate <= 0.0) return cfg.measure * 1e6; // fara trafic: practic nu ne mai trezim
+        if (cfg.process == INJECT_POISSON) {
+            std::exponential_distribution<double> exp_dist(cfg.rate);
+            return cfg.cycle * exp_dist(rng);
+        }
+        if (cfg.rate >= 1.0) return cfg.cycle;
+        std::geometric_distribution<int> geo(cfg.rate);
+        return cfg.cycle * (double)(geo(rng) + 1);
+    }
+
+    int pick_destination() {
+        int x = id_x(my_id), y = id_y(my_id);
+        switch (cfg.pattern) {
+            case TRAFFIC_HOTSPOT:
+                if (uni(rng) < cfg.hotspot_frac) return cfg.hotspot_id;
+                return uniform_destination();
+            case TRAFFIC_TRANSPOSE:
+                // pe un mesh ne-patrat pliem coordonatele in interiorul mesh-ului
+                return xy_id(y % cols, x % rows);
+            case TRAFFIC_BITCOMP:
+                return xy_id(cols - 1 - x, rows - 1 - y);
+            case TRAFFIC_NEIGHBOUR:
+                return xy_id((x + 1) % cols, y);
+            case TRAFFIC_UNIFORM:
+            default:
+                return uniform_destination();
+        }
+    }
+
+    // Un nod aleator din mesh, diferit de noi (daca mesh-ul are mai mult de un nod)
+    int uniform_destination() {
+        int n = rows * cols;
+        if (n < 2) return my_id;
+        int self = id_y(my_id) * cols + id_x(my_id);
+        int k = (int)(uni(rng) * (n - 1));
+        if (k >= n - 1) k = n - 2;
+        if (k >= self) k++;
+        return xy_id(k % cols, k / cols);
+    }
+};
+
+#endif
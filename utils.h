@@ -4,10 +4,10 @@
 
 #include <systemc.h>
 #include <iostream>
-
-enum PortID { N = 0, S = 1, E = 2, V = 3 }; 
-enum ArbMode { PRIORITY = 0, ROUND_ROBIN = 1 };
-const char* PortNames[] = { "NORD", "SUD", "EST", "VEST" };
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "noc_types.h"
 
 // Asta este practic "masina" care transporta datele -> L0
 // struct packet {
@@ -42,24 +42,51 @@ struct packet {
         RSP_DATA = 3   // MEM trimite datele cerute înapoi la CPU
     };
 
+    // Wormhole: un pachet lung e impartit in flit-uri (HEAD, BODY..., TAIL), fiecare fiind un `packet` in FIFO.
+    // Un pachet de un singur flit (SINGLE) e in acelasi timp si cap si coada (comportamentul original).
+    enum Flit {
+        FLIT_SINGLE = 0,
+        FLIT_HEAD = 1,
+        FLIT_BODY = 2,
+        FLIT_TAIL = 3
+    };
+
     Type type;     // Tipul mesajului curent
     int src_id;    // Cine a inițiat (ex: CPU ID)
     int dst_id;    // Destinația curentă (ex: MEM ID)
     int address;   // Adresa din memorie unde scriem/citim
     int data;      // Datele efective (pentru WRITE sau RSP_DATA)
+    int tag;       // Eticheta tranzactiei: MEM o copiaza in raspuns, ca CPU sa poata avea mai multe cereri in zbor
+    int flit;      // Flit (SINGLE / HEAD / BODY / TAIL); toate flit-urile unui pachet poarta acelasi antet
+    int len;       // Lungimea burst-ului in cuvinte (WRITE / DATA: numarul de flit-uri; READ: cate cuvinte cerem)
+    sc_time inject_time; // Momentul in care pachetul a fost creat la sursa (pentru latenta, vezi traffic.h)
 
     // Constructor Default
-    packet() : type(REQ_WRITE), src_id(0), dst_id(0), address(0), data(0) {}
+    packet() : type(REQ_WRITE), src_id(0), dst_id(0), address(0), data(0), tag(0), flit(FLIT_SINGLE), len(1), inject_time(SC_ZERO_TIME) {}
 
     // Constructor Parametrizat
-    packet(Type t, int s, int d, int addr, int val) 
-        : type(t), src_id(s), dst_id(d), address(addr), data(val) {}
+    packet(Type t, int s, int d, int addr, int val, int tg = 0) 
+        : type(t), src_id(s), dst_id(d), address(addr), data(val), tag(tg), flit(FLIT_SINGLE), len(1), inject_time(SC_ZERO_TIME) {}
+
+    bool is_head() const { return flit == FLIT_SINGLE || flit == FLIT_HEAD; }
+    bool is_tail() const { return flit == FLIT_SINGLE || flit == FLIT_TAIL; }
+    // Clasa mesajului: cererile si raspunsurile pot merge pe FIFO-uri separate (vezi Router::rsp_in / rsp_out)
+    bool is_response() const { return type == RSP_ACK || type == RSP_DATA; }
+
+    // Flit-ul i (0..n-1) al unui pachet de n flit-uri, cu antetul lui p si cuvantul de date val
+    static packet make_flit(const packet& p, int i, int n, int val) {
+        packet f(p);
+        f.flit = (n == 1) ? FLIT_SINGLE : (i == 0) ? FLIT_HEAD : (i == n - 1) ? FLIT_TAIL : FLIT_BODY;
+        f.len = n;
+        f.data = val;
+        return f;
+    }
 
     // Operator == (Necesar pentru systemc semnale/fifo)
     bool operator==(const packet& other) const {
         return (type == other.type && src_id == other.src_id && 
                 dst_id == other.dst_id && address == other.address && 
-                data == other.data);
+                data == other.data && tag == other.tag && flit == other.flit && len == other.len);
     }
     
     friend std::ostream& operator<<(std::ostream& os, const packet& p) {
@@ -72,37 +99,14 @@ struct packet {
             default:        os << "???? "; break;
         }
         os << " Src:" << p.src_id << " -> Dst:" << p.dst_id 
-           << " Addr:" << p.address << " Data:" << p.data << "]";
-        return os;
-    }
-};
-
-// Structura pentru tranzactii de configurare (deci practic cu acesta ii spunem routerului ce sa faca)
-struct cfg_trans {
-    // AM ADAUGAT INAPOI SET_ARBITER
-    enum Type { SET_ROUTE = 0, ENABLE_PORT = 1, SET_Q_LEN = 2, SET_ARBITER = 3 };
-    // SET_ROUTE: comanda de schimbare a tabelei de rutare
-    // ENABLE_PORT: comanda de activare/dezactivare port
-    // SET_Q_LEN: comanda de setare lungime coada
-    // SET_ARBITER: comanda de schimbare a regulii de prioritate
-
-    int type; //Tipul comenzii
-    int target; //Pt SET_ROUTE: adresa destinatar; Pt ENABLE_PORT: id port
-    int value;  //Pt SET_ROUTE: id port de iesire; Pt SET_ARBITER: 0=FixPriority, 1=RR
-
-    cfg_trans() : type(0), target(0), value(0) {}
-
-    cfg_trans(int t, int tg, int v) : type(t), target(tg), value(v) {}
-
-    bool operator==(const cfg_trans& other) const {
-        return (type == other.type && target == other.target && value == other.value);
-    }
-
-    friend ostream& operator<<(ostream& os, const cfg_trans& t) {
-        os << "{CFG Type:" << t.type << " Tgt:" << t.target << " Val:" << t.value << "}";
+           << " Addr:" << p.address << " Data:" << p.data;
+        if (p.flit != FLIT_SINGLE) {
+            static const char* flit_names[] = { "", "HEAD", "BODY", "TAIL" };
+            os << " " << flit_names[p.flit] << "/" << p.len;
+        }
+        os << "]";
         return os;
     }
 };
 
-
 #endif
\ No newline at end of file
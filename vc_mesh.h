@@ -0,0 +1,197 @@
+// vc_mesh.h
+#ifndef VC_MESH_H
+#define VC_MESH_H
+
+#include <systemc.h>
+#include <vector>
+#include <string>
+#include "utils.h"
+#include "vc_router.h"
+#include "cpu_v1.h"
+#include "mem.h"
+#include "traffic.h"
+#include "stats.h"
+
+// Acelasi mesh R x C ca in mesh.h, dar cu VCRouter: legaturile dintre routere sunt vc_link
+// (num_vcs canale virtuale a cate vc_depth pachete), iar perifericele raman pe sc_fifo pe portul local.
+// Are aceeasi interfata ca Mesh (at, cfg, attach_*, traffic, dump_stats), ca sa poata fi folosit
+// de aceleasi scenarii.
+// Cu torus = true randurile si coloanele de cel putin 3 routere se inchid in inel (legaturi wraparound intre
+// capete): 1 x N e un inel bidirectional, R x C un tor 2D. Rutarea XY merge pe sensul mai scurt al fiecarui inel,
+// iar legaturile wraparound sunt dateline pentru clasele de VC (vezi VCRouter::out_class), deci trebuie vcs >= 2.
+SC_MODULE(VCMesh) {
+    int rows, cols;
+    bool torus;
+    int num_vcs;
+    int vc_depth;   // pachete per VC pe fiecare legatura router-router
+    int fifo_depth; // adancimea FIFO-urilor catre periferice
+
+    std::vector<VCRouter*> routers; // routers[y * cols + x]
+    std::vector<CPU*> cpus;
+    std::vector<MEM*> mems;
+    std::vector<TrafficGen*> traffic;
+
+    std::vector<vc_link*> links;                  // legaturile router-router (cate una pe fiecare sens)
+    std::vector<stat_fifo<packet>*> periph_links; // legaturile catre periferice
+    std::vector<vc_link*> dummy_links;            // porturile N/S/E/V inchise
+    std::vector<sc_fifo<packet>*> dummy_fifos;    // porturile locale inchise
+    std::vector<sc_fifo<cfg_trans>*> cfg_fifos;
+
+    std::vector<bool> local_used;
+
+    VCRouter* at(int x, int y) { return routers[y * cols + x]; }
+
+    sc_fifo<cfg_trans>& cfg(int x, int y) { return *cfg_fifos[y * cols + x]; }
+
+    SC_HAS_PROCESS(VCMesh);
+
+    VCMesh(sc_module_name name, int r, int c, int vcs, int depth_per_vc, int depth = 16, bool wrap = false)
+        : sc_module(name), rows(r), cols(c), torus(wrap), num_vcs(vcs), vc_depth(depth_per_vc), fifo_depth(depth), local_used(r * c, false)
+    {
+        bool wrap_x = torus && cols > 2, wrap_y = torus && rows > 2;
+
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                std::string rname = "VCRouter_" + std::to_string(x) + "_" + std::to_string(y);
+                VCRouter* rt = new VCRouter(rname.c_str());
+                rt->routing_mode = ROUTE_XY;
+                rt->my_x = x;
+                rt->my_y = y;
+                rt->ring_cols = wrap_x ? cols : 0;
+                rt->ring_rows = wrap_y ? rows : 0;
+
+                sc_fifo<cfg_trans>* f_cfg = new sc_fifo<cfg_trans>(16);
+                rt->cfg_port(*f_cfg);
+                cfg_fifos.push_back(f_cfg);
+
+                routers.push_back(rt);
+            }
+        }
+
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x + 1 < cols; x++) connect(at(x, y), E, at(x + 1, y), V);
+        }
+        for (int y = 0; y + 1 < rows; y++) {
+            for (int x = 0; x < cols; x++) connect(at(x, y), S, at(x, y + 1), N);
+        }
+
+        // Legaturile wraparound: iesirile care intra pe ele sunt dateline-ul inelului, pe fiecare sens
+        if (wrap_x) {
+            for (int y = 0; y < rows; y++) {
+                connect(at(cols - 1, y), E, at(0, y), V);
+                at(cols - 1, y)->dateline[E] = true;
+                at(0, y)->dateline[V] = true;
+            }
+        }
+        if (wrap_y) {
+            for (int x = 0; x < cols; x++) {
+                connect(at(x, rows - 1), S, at(x, 0), N);
+                at(x, rows - 1)->dateline[S] = true;
+                at(x, 0)->dateline[N] = true;
+            }
+        }
+
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) {
+                if (y == 0 && !wrap_y)        close_port(at(x, y), N);
+                if (y == rows - 1 && !wrap_y) close_port(at(x, y), S);
+                if (x == cols - 1 && !wrap_x) close_port(at(x, y), E);
+                if (x == 0 && !wrap_x)        close_port(at(x, y), V);
+            }
+        }
+    }
+
+    CPU* attach_cpu(int x, int y, int target, int addr, int data) {
+        CPU* c = new CPU(("CPU_" + std::to_string(x) + "_" + std::to_string(y)).c_str(), xy_id(x, y), target, addr, data);
+        cpus.push_back(c);
+        attach_local(x, y, c, "_req", "_rsp");
+        return c;
+    }
+
+    MEM* attach_mem(int x, int y) {
+        MEM* m = new MEM(("MEM_" + std::to_string(x) + "_" + std::to_string(y)).c_str(), xy_id(x, y));
+        mems.push_back(m);
+        attach_local(x, y, m, "_rsp", "_req");
+        return m;
+    }
+
+    TrafficGen* attach_traffic(int x, int y, const TrafficConfig& tcfg) {
+        TrafficGen* t = new TrafficGen(("TG_" + std::to_string(x) + "_" + std::to_string(y)).c_str(), xy_id(x, y), rows, cols, tcfg);
+        traffic.push_back(t);
+        attach_local(x, y, t, "_inj", "_ej");
+        return t;
+    }
+
+    void attach_traffic_all(const TrafficConfig& tcfg) {
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < cols; x++) attach_traffic(x, y, tcfg);
+        }
+    }
+
+    // Legaturile router-router in <prefix>_links.csv / .json, iar FIFO-urile perifericelor separat
+    void dump_stats(const std::string& prefix) {
+        ::dump_stats(prefix, routers, links, routers[0]->cycle_time);
+        write_link_csv(prefix + "_local_links.csv", periph_links, routers[0]->cycle_time);
+    }
+
+    void before_end_of_elaboration() {
+        for (int i = 0; i < rows * cols; i++) {
+            if (!local_used[i]) {
+                close_local(routers[i]);
+                local_used[i] = true;
+            }
+        }
+    }
+
+private:
+    // Leaga un periferic (out_port / in_port) pe portul local al routerului (x, y)
+    template <class P>
+    void attach_local(int x, int y, P* periph, const char* to_router, const char* from_router) {
+        stat_fifo<packet>* f_in = new stat_fifo<packet>((std::string(periph->basename()) + to_router).c_str(), fifo_depth);
+        periph->out_port(*f_in);
+        at(x, y)->local_in(*f_in);
+        periph_links.push_back(f_in);
+
+        stat_fifo<packet>* f_out = new stat_fifo<packet>((std::string(periph->basename()) + from_router).c_str(), fifo_depth);
+        at(x, y)->local_out(*f_out);
+        periph->in_port(*f_out);
+        periph_links.push_back(f_out);
+
+        local_used[y * cols + x] = true;
+    }
+
+    void connect(VCRouter* a, int pa, VCRouter* b, int pb) {
+        vc_link* ab = new vc_link(link_name(a, pa).c_str(), num_vcs, vc_depth);
+        vc_link* ba = new vc_link(link_name(b, pb).c_str(), num_vcs, vc_depth);
+        a->out_links[pa](*ab);
+        b->in_links[pb](*ab);
+        b->out_links[pb](*ba);
+        a->in_links[pa](*ba);
+        links.push_back(ab);
+        links.push_back(ba);
+    }
+
+    std::string link_name(VCRouter* from, int port) {
+        return std::string("link_") + from->basename() + "_" + PortNames[port];
+    }
+
+    void close_port(VCRouter* rt, int port) {
+        rt->port_enabled[port] = false;
+        vc_link* d = new vc_link((link_name(rt, port) + "_closed").c_str(), 1, 1);
+        rt->in_links[port](*d);
+        rt->out_links[port](*d);
+        dummy_links.push_back(d);
+    }
+
+    void close_local(VCRouter* rt) {
+        rt->port_enabled[L] = false;
+        sc_fifo<packet>* d1 = new sc_fifo<packet>(1);
+        sc_fifo<packet>* d2 = new sc_fifo<packet>(1);
+        rt->local_in(*d1);
+        rt->local_out(*d2);
+        dummy_fifos.push_back(d1);
+        dummy_fifos.push_back(d2);
+    }
+};
+
+#endif
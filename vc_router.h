@@ -0,0 +1,429 @@
+// vc_router.h
+#ifndef VC_ROUTER_H
+#define VC_ROUTER_H
+
+#include <systemc.h>
+#include <vector>
+#include <deque>
+#include <cmath>
+#include "utils.h"
+#include "log.h"
+#include "route_table.h"
+#include "stats.h"
+#include "router.h"
+
+// Porturile N/S/E/V sunt legaturi cu canale virtuale (vc_link); portul local ramane un sc_fifo obisnuit
+const int NUM_LINK_PORTS = 4;
+
+// Partea de receptie a unei legaturi cu canale virtuale (routerul din aval)
+class vc_in_if : virtual public sc_interface {
+public:
+    virtual int num_vcs() const = 0;
+    virtual int num_available(int vc) const = 0;
+    virtual const packet& peek(int vc) const = 0;
+    virtual packet read(int vc) = 0; // scoate pachetul din VC si trimite un credit inapoi la emitator
+    virtual const sc_event& data_written_event() const = 0;
+};
+
+// Partea de emisie (routerul din amonte)
+class vc_out_if : virtual public sc_interface {
+public:
+    virtual int num_vcs() const = 0;
+    virtual int credits(int vc) const = 0; // locuri libere in bufferul VC-ului din aval, asa cum le stie emitatorul
+    virtual bool send(const packet& p, int vc) = 0; // consuma un credit; false daca VC-ul nu mai are credite
+    virtual const sc_event& credit_event() const = 0;
+};
+
+// Legatura unidirectionala intre doua routere: num_vcs buffere separate la receptie (cate depth pachete fiecare)
+// si cate un contor de credite per VC la emitator. Emitatorul scade un credit la fiecare send(),
+// receptorul il da inapoi la fiecare read(). Ca la sc_fifo, pachetele si creditele devin vizibile
+// abia dupa faza de update, deci un credit eliberat intr-un ciclu poate fi folosit din ciclul urmator.
+class vc_link : public vc_in_if, public vc_out_if, public sc_prim_channel {
+public:
+    vc_link(const char* name, int vcs, int depth_per_vc)
+        : sc_prim_channel(name), capacity(vcs * depth_per_vc), max_occupancy(0), write_stalls(0), depth(depth_per_vc),
+          buffers(vcs), credit(vcs, depth_per_vc), returned(vcs, 0),
+          cur_occupancy(0), occupancy_integral(0.0) {}
+
+    int capacity;      // total pachete (toate VC-urile)
+    int max_occupancy; // maximul de pachete aflate simultan in buffere
+    unsigned long write_stalls; // send() refuzate pentru ca VC-ul nu mai avea credite
+
+    int num_vcs() const { return (int)buffers.size(); }
+    int vc_depth() const { return depth; }
+
+    // --- receptie ---
+    int num_available(int vc) const { return (int)buffers[vc].size(); }
+    const packet& peek(int vc) const { return buffers[vc].front(); }
+
+    packet read(int vc) {
+        packet p = buffers[vc].front();
+        buffers[vc].pop_front();
+        returned[vc]++;
+        request_update();
+        return p;
+    }
+
+    const sc_event& data_written_event() const { return written_event; }
+
+    // --- emisie ---
+    int credits(int vc) const { return credit[vc]; }
+
+    bool send(const packet& p, int vc) {
+        if (credit[vc] == 0) {
+            write_stalls++;
+            return false;
+        }
+        credit[vc]--;
+        pending.push_back(std::make_pair(vc, p));
+        request_update();
+        return true;
+    }
+
+    const sc_event& credit_event() const { return credit_returned; }
+
+    // Ocupanta medie (ponderata in timp), ca la stat_fifo
+    double avg_occupancy() const {
+        double now = sc_time_stamp().to_seconds();
+        if (now <= 0.0) return cur_occupancy;
+        return (occupancy_integral + cur_occupancy * (now - last_change.to_seconds())) / now;
+    }
+
+    // Cat timp au fost pline toate bufferele legaturii, ca la stat_fifo
+    sc_time full_time() const {
+        if (cur_occupancy < capacity) return full_integral;
+        return full_integral + (sc_time_stamp() - last_change);
+    }
+
+protected:
+    void update() {
+        if (!pending.empty()) {
+            for (size_t i = 0; i < pending.size(); i++) buffers[pending[i].first].push_back(pending[i].second);
+            pending.clear();
+            written_event.notify(SC_ZERO_TIME);
+        }
+
+        bool any_credit = false;
+        for (size_t vc = 0; vc < returned.size(); vc++) {
+            if (returned[vc] == 0) continue;
+            credit[vc] += returned[vc];
+            returned[vc] = 0;
+            any_credit = true;
+        }
+        if (any_credit) credit_returned.notify(SC_ZERO_TIME);
+
+        int occ = 0;
+        for (size_t vc = 0; vc < buffers.size(); vc++) occ += (int)buffers[vc].size();
+        if (occ != cur_occupancy) {
+            sc_time now = sc_time_stamp();
+            occupancy_integral += cur_occupancy * (now - last_change).to_seconds();
+            if (cur_occupancy >= capacity) full_integral += now - last_change;
+            last_change = now;
+            cur_occupancy = occ;
+            if (occ > max_occupancy) max_occupancy = occ;
+        }
+    }
+
+private:
+    int depth;
+    std::vector<std::deque<packet> > buffers;         // bufferele de la receptie, cate unul per VC
+    std::vector<int> credit;                          // creditele emitatorului, per VC
+    std::vector<int> returned;                        // credite eliberate in delta-ciclul curent
+    std::vector<std::pair<int, packet> > pending;     // pachete trimise in delta-ciclul curent
+    sc_event written_event, credit_returned;
+
+    int cur_occupancy;
+    double occupancy_integral;
+    sc_time full_integral;
+    sc_time last_change;
+};
+
+// Router cu canale virtuale si flow control pe credite.
+// Diferente fata de Router:
+//  - fiecare intrare N/S/E/V are num_vcs cozi separate, deci un pachet blocat nu mai blocheaza
+//    pachetele din spatele lui care merg spre alta iesire (head-of-line blocking)
+//  - nu exista write() blocant: un pachet pleaca doar daca iesirea are credit, altfel arbitrarea
+//    il sare si incearca alt VC; routerul continua sa lucreze pentru iesirile libere
+//  - in fiecare ciclu fiecare intrare propune un pachet si fiecare iesire accepta cel mult unul
+//    (alocare separabila: intai pe intrari, apoi pe iesiri)
+// Cu num_vcs = 1 e acelasi router fara canale virtuale (referinta pentru comparatii).
+SC_MODULE(VCRouter) {
+    sc_port<vc_in_if>  in_links[NUM_LINK_PORTS];  // N, S, E, V
+    sc_port<vc_out_if> out_links[NUM_LINK_PORTS];
+    sc_fifo_in<packet>  local_in;  // portul local (L): CPU / MEM / generator de trafic
+    sc_fifo_out<packet> local_out;
+    sc_fifo_in<cfg_trans> cfg_port;
+
+    RouteTable routing_table;
+    bool port_enabled[NUM_PORTS];
+    int arbitration_policy; // PRIORITY / ROUND_ROBIN / OLDEST_FIRST / WEIGHTED_RR, aplicat pe fiecare iesire intre intrari
+    int arb_weight[NUM_PORTS]; // WEIGHTED_RR: grant-uri consecutive pe runda pentru fiecare intrare (SET_ARB_WEIGHT)
+    int routing_mode;
+    int my_x, my_y;
+    // Tor / inel (vezi VCMesh): dimensiunea inelului pe X / Y, 0 = dimensiunea nu se inchide. Cu macar un inel VC-urile
+    // se impart in doua clase (jumatatea de jos / de sus) si un pachet trece in clasa 1 cand iese pe o legatura
+    // wraparound (dateline[out]); pe fiecare inel dependentele dintre VC-uri nu mai pot face cerc, deci nici deadlock.
+    int ring_cols, ring_rows;
+    bool dateline[NUM_LINK_PORTS];
+
+    RouterStats stats; // blocked_time = cicluri in care un pachet a asteptat credite
+
+    // Inregistrarea evenimentelor, ca la Router (NULL = oprita); perifericele stau doar pe L
+    EventRecorder::Ring* events;
+    bool edge_port[NUM_PORTS];
+
+    sc_time cycle_time;
+    sc_time t_ref;
+    sc_event_or_list wake_events;
+
+    void process() {
+        for (int p = 0; p < NUM_LINK_PORTS; p++) {
+            wake_events |= in_links[p]->data_written_event();
+            wake_events |= out_links[p]->credit_event();
+        }
+        wake_events |= local_in.data_written_event();
+        wake_events |= local_out.data_read_event();
+        wake_events |= cfg_port.data_written_event();
+
+        t_ref = sc_time_stamp();
+        bool moved = false;
+
+        while (true) {
+            if (moved) {
+                wait(cycle_time);
+            } else {
+                // Nimic nu s-a miscat in ciclul trecut: ori n-avem pachete, ori toate asteapta credite.
+                // In ambele cazuri asteptam un pachet nou / un credit / o comanda, apoi tick-ul urmator.
+                do {
+                    wait(wake_events);
+                } while (!has_work());
+
+                wait(time_to_next_tick());
+            }
+
+            moved = step();
+            t_ref = sc_time_stamp();
+        }
+    }
+
+    sc_time time_to_next_tick() {
+        double ticks = floor((sc_time_stamp() - t_ref) / cycle_time) + 1;
+        return t_ref + cycle_time * ticks - sc_time_stamp();
+    }
+
+    bool has_work() {
+        if (cfg_port.num_available() > 0) return true;
+        if (port_enabled[L] && (local_valid || local_in.num_available() > 0)) return true;
+        for (int p = 0; p < NUM_LINK_PORTS; p++) {
+            if (!port_enabled[p]) continue;
+            for (int vc = 0; vc < in_links[p]->num_vcs(); vc++) {
+                if (in_links[p]->num_available(vc) > 0) return true;
+            }
+        }
+        return false;
+    }
+
+    // Un ciclu: config, alocare pe intrari, alocare pe iesiri, transfer.
+    // Intoarce true daca s-a miscat (sau s-a aruncat) cel putin un pachet.
+    bool step() {
+        cfg_trans cfg;
+        bool moved = false;
+        while (cfg_port.nb_read(cfg)) {
+            apply_router_config(*this, cfg);
+            moved = true;
+        }
+
+        if (port_enabled[L] && !local_valid) local_valid = local_in.nb_read(local_head);
+
+        // 1. Fiecare intrare alege un VC al carui pachet din fata are credit pe iesirea dorita
+        //    (round-robin intre VC-uri; cu OLDEST_FIRST pe cel cu inject_time minim)
+        int request_out[NUM_PORTS];
+        int request_vc[NUM_PORTS];
+        bool stalled = false;
+
+        for (int in = 0; in < NUM_PORTS; in++) {
+            request_out[in] = -1;
+            if (!port_enabled[in]) continue;
+
+            int vcs = (in == L) ? 1 : in_links[in]->num_vcs();
+            for (int k = 1; k <= vcs; k++) {
+                int vc = (last_vc[in] + k) % vcs;
+                if (!head_valid(in, vc)) continue;
+
+                const packet& p = head(in, vc);
+                int out = route(p.dst_id);
+
+                if (out == RouteTable::NO_ROUTE || !port_enabled[out]) {
+                    drop(in, vc, out); // nu are rost sa asteptam, pachetul nu poate pleca niciodata
+                    last_vc[in] = vc;
+                    moved = true;
+                    break;
+                }
+                if (out_vc_for(out, out_class(in, vc, out)) < 0) { // iesirea nu are credite, incercam alt VC
+                    stalled = true;
+                    continue;
+                }
+                if (request_out[in] >= 0 && !(p.inject_time < head(in, request_vc[in]).inject_time)) continue;
+                request_out[in] = out;
+                request_vc[in] = vc;
+                if (arbitration_policy != OLDEST_FIRST) break;
+            }
+        }
+
+        // 2. Fiecare iesire alege una dintre intrarile care o cer (dupa arbitration_policy, ca Router::crossbar_step)
+        for (int out = 0; out < NUM_PORTS; out++) {
+            int start = arb_start(arbitration_policy, last_in[out], grant_left[out]);
+            int in = -1;
+            for (int k = 0; k < NUM_PORTS; k++) {
+                int cand = (start + k) % NUM_PORTS;
+                if (request_out[cand] != out) continue;
+                if (in < 0 || head(cand, request_vc[cand]).inject_time < head(in, request_vc[in]).inject_time) in = cand;
+                if (arbitration_policy != OLDEST_FIRST) break;
+            }
+            if (in < 0) continue;
+
+            forward(in, request_vc[in], out);
+            grant_left[out] = arb_left_after(arbitration_policy, in, last_in[out], grant_left[out], arb_weight);
+            last_in[out] = in;
+            last_vc[in] = request_vc[in];
+            moved = true;
+        }
+
+        if (stalled) stats.blocked_time += cycle_time;
+        return moved;
+    }
+
+    int route(int dst_id) {
+        if (routing_mode == ROUTE_XY) {
+            if (ring_cols > 0 || ring_rows > 0) return torus_route_port(my_x, my_y, dst_id, ring_cols, ring_rows);
+            return xy_route_port(my_x, my_y, dst_id);
+        }
+        return routing_table.lookup(dst_id);
+    }
+
+    SC_CTOR(VCRouter) {
+        SC_THREAD(process);
+        for (int i = 0; i < NUM_PORTS; i++) {
+            port_enabled[i] = true;
+            last_vc[i] = 0;
+            last_in[i] = NUM_PORTS - 1;
+            grant_left[i] = 0;
+            arb_weight[i] = 1;
+            edge_port[i] = (i == L);
+        }
+        for (int p = 0; p < NUM_LINK_PORTS; p++) {
+            next_out_vc[p] = 0;
+            dateline[p] = false;
+        }
+        cycle_time = sc_time(10, SC_NS);
+        arbitration_policy = ROUND_ROBIN;
+        routing_mode = ROUTE_TABLE;
+        my_x = 0;
+        my_y = 0;
+        ring_cols = 0;
+        ring_rows = 0;
+        events = NULL;
+        local_valid = false;
+    }
+
+private:
+    int last_vc[NUM_PORTS];          // round-robin intre VC-urile fiecarei intrari
+    int last_in[NUM_PORTS];          // round-robin intre intrari, pe fiecare iesire
+    int grant_left[NUM_PORTS];       // WEIGHTED_RR: grant-urile ramase pentru last_in[out] in runda curenta
+    int next_out_vc[NUM_LINK_PORTS]; // round-robin intre VC-urile din aval la egalitate de credite
+
+    // sc_fifo nu are peek, asa ca pachetul din fata cozii locale e tinut intr-un registru
+    packet local_head;
+    bool local_valid;
+
+    bool head_valid(int in, int vc) {
+        if (in == L) return local_valid;
+        return in_links[in]->num_available(vc) > 0;
+    }
+
+    const packet& head(int in, int vc) {
+        if (in == L) return local_head;
+        return in_links[in]->peek(vc);
+    }
+
+    packet pop(int in, int vc) {
+        if (in == L) {
+            local_valid = false;
+            return local_head;
+        }
+        return in_links[in]->read(vc); // creditul se intoarce la routerul din amonte
+    }
+
+    // Clasa de VC pe iesirea out pentru pachetul din VC-ul in_vc al intrarii in (-1 = fara clase, orice VC).
+    // Pachetul pleaca in clasa 0 cand intra in retea sau schimba dimensiunea (X <-> Y), trece in clasa 1 pe
+    // legatura wraparound si ramane acolo pana la capatul dimensiunii.
+    int out_class(int in, int in_vc, int out) {
+        if (out == L || (ring_cols == 0 && ring_rows == 0)) return -1;
+        if (dateline[out]) return 1;
+        bool in_y = (in == N || in == S), out_y = (out == N || out == S);
+        if (in == L || in_y != out_y) return 0;
+        return (in_vc >= in_links[in]->num_vcs() / 2) ? 1 : 0;
+    }
+
+    // VC-ul din aval pe care am trimite acum pe iesirea out (cel cu cele mai multe credite), sau -1 daca nu e loc.
+    // cls >= 0 restrange cautarea la VC-urile clasei (vezi out_class).
+    // Pe portul local nu avem VC-uri, "creditele" sunt locurile libere din FIFO.
+    int out_vc_for(int out, int cls) {
+        if (out == L) return (local_out.num_free() > 0) ? 0 : -1;
+
+        int vcs = out_links[out]->num_vcs();
+        int lo = 0, hi = vcs;
+        if (cls >= 0) {
+            lo = (cls == 0) ? 0 : vcs / 2;
+            hi = (cls == 0) ? vcs / 2 : vcs;
+        }
+        int best = -1, best_credits = 0;
+        for (int k = 0; k < vcs; k++) {
+            int vc = (next_out_vc[out] + k) % vcs;
+            if (vc < lo || vc >= hi) continue;
+            int c = out_links[out]->credits(vc);
+            if (c > best_credits) {
+                best = vc;
+                best_credits = c;
+            }
+        }
+        return best;
+    }
+
+    void forward(int in, int in_vc, int out) {
+        int out_vc = out_vc_for(out, out_class(in, in_vc, out));
+        packet p = pop(in, in_vc);
+        stats.arb_wins[in]++;
+        stats.forwarded[in][out]++;
+        record_grant(events, edge_port, in, out, p);
+        record_forward(events, edge_port, in, out, p);
+
+        if (out == L) {
+            local_out.nb_write(p);
+        } else {
+            out_links[out]->send(p, out_vc);
+            next_out_vc[out] = (out_vc + 1) % out_links[out]->num_vcs();
+        }
+
+        NOC_LOG(LOG_TRACE, "@" << sc_time_stamp() << " [VC ROUTER] Pkt in port " << PortNames[in] << " VC " << in_vc << ": " << p
+             << " -> Fwd to Port " << PortNames[out] << " VC " << out_vc << endl);
+    }
+
+    void drop(int in, int vc, int out) {
+        packet p = pop(in, vc);
+        stats.arb_wins[in]++;
+        record_grant(events, edge_port, in, out, p);
+        record_drop(events, in, out, p);
+        if (out == RouteTable::NO_ROUTE) {
+            stats.drop_no_route++;
+            NOC_LOG(LOG_TRACE, "@" << sc_time_stamp() << " [VC ROUTER] Pkt in port " << PortNames[in] << " VC " << vc << ": " << p
+                 << " -> DROP: No route for Destination " << p.dst_id << endl);
+        } else {
+            stats.drop_disabled++;
+            NOC_LOG(LOG_TRACE, "@" << sc_time_stamp() << " [VC ROUTER] Pkt in port " << PortNames[in] << " VC " << vc << ": " << p
+                 << " -> DROP: Port " << PortNames[out] << " disabled" << endl);
+        }
+    }
+};
+
+#endif